@@ -0,0 +1,51 @@
+# obfuscxx_embed(<target> NAME <identifier> INPUT <file>
+#                [LEVEL Low|Medium|High] [ENTROPY <integer>] [NAMESPACE <namespace>])
+#
+# Encrypts INPUT at build time with the obfuscxx_embed host tool and adds the generated header
+# obfuscxx_embed/<NAME>.h to <target>. The header declares
+#
+#     ngu::obfuscxx_blob<std::uint8_t, <file size>, ngu::obf_level::<LEVEL>, <ENTROPY>> NAME;
+#
+# which decrypts the data with the regular obfuscxx kernels. Without ENTROPY every build uses a fresh key.
+function(obfuscxx_embed target)
+    cmake_parse_arguments(PARSE_ARGV 1 ARG "" "NAME;INPUT;LEVEL;ENTROPY;NAMESPACE" "")
+
+    if(NOT ARG_NAME OR NOT ARG_INPUT)
+        message(FATAL_ERROR "obfuscxx_embed: NAME and INPUT are required")
+    endif()
+    if(NOT TARGET obfuscxx::embed)
+        message(FATAL_ERROR "obfuscxx_embed: the obfuscxx::embed tool is not available (OBFUSCXX_BUILD_EMBED_TOOL is OFF)")
+    endif()
+
+    get_target_property(tool obfuscxx::embed ALIASED_TARGET)
+    if(NOT tool)
+        set(tool obfuscxx::embed)
+    endif()
+
+    get_filename_component(input "${ARG_INPUT}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/obfuscxx_embed")
+    set(output "${output_dir}/${ARG_NAME}.h")
+
+    set(args "${input}" "${output}" "${ARG_NAME}")
+    if(ARG_LEVEL)
+        list(APPEND args --level "${ARG_LEVEL}")
+    endif()
+    if(ARG_ENTROPY)
+        list(APPEND args --entropy "${ARG_ENTROPY}")
+    endif()
+    if(ARG_NAMESPACE)
+        list(APPEND args --namespace "${ARG_NAMESPACE}")
+    endif()
+
+    add_custom_command(
+            OUTPUT "${output}"
+            COMMAND "${CMAKE_COMMAND}" -E make_directory "${output_dir}"
+            COMMAND "$<TARGET_FILE:${tool}>" ${args}
+            DEPENDS "${input}" ${tool}
+            COMMENT "Encrypting ${ARG_INPUT} as ${ARG_NAME}"
+            VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${output}")
+    target_include_directories(${target} PRIVATE "${CMAKE_CURRENT_BINARY_DIR}")
+endfunction()
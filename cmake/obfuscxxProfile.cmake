@@ -0,0 +1,76 @@
+# obfuscxx_profile(<target> [SEED <integer>])
+#
+# Instrumentation build of <target>: every get() and copy_to() call of an obfuscxx instance is counted per
+# instantiation and construction site, and the counts are written to obfuscxx.profile (or $OBFUSCXX_PROFILE_FILE) in
+# the working directory when the program exits.
+#
+# obfuscxx_level_overrides(<target> PROFILE <file>... [HOT_PERCENT <n>] [LEVEL Low|Medium|High] [SEED <integer>])
+#
+# Builds <target> with the HOT_PERCENT (default 1) most called instantiations in the profiles moved to LEVEL
+# (default Low), without touching the sources. Instantiations are recognized by their type, entropy included, so both
+# functions pin OBFUSCXX_ENTROPY_SEED; by default to a value derived from the target name, which has to match between
+# the profiling and the final build.
+function(_obfuscxx_profile_seed target out)
+    cmake_parse_arguments(PARSE_ARGV 2 ARG "" "SEED" "")
+    if(ARG_SEED)
+        set(${out} "${ARG_SEED}" PARENT_SCOPE)
+    else()
+        string(SHA1 hash "${target}")
+        string(SUBSTRING "${hash}" 0 15 hash)
+        set(${out} "0x${hash}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+function(obfuscxx_profile target)
+    cmake_parse_arguments(PARSE_ARGV 1 ARG "" "SEED" "")
+    _obfuscxx_profile_seed(${target} seed SEED "${ARG_SEED}")
+    target_compile_definitions(${target} PRIVATE OBFUSCXX_PROFILE OBFUSCXX_ENTROPY_SEED=${seed})
+endfunction()
+
+function(obfuscxx_level_overrides target)
+    cmake_parse_arguments(PARSE_ARGV 1 ARG "" "HOT_PERCENT;LEVEL;SEED" "PROFILE")
+
+    if(NOT ARG_PROFILE)
+        message(FATAL_ERROR "obfuscxx_level_overrides: PROFILE is required")
+    endif()
+    if(NOT TARGET obfuscxx::levels)
+        message(FATAL_ERROR
+                "obfuscxx_level_overrides: the obfuscxx::levels tool is not available (OBFUSCXX_BUILD_LEVELS_TOOL is OFF)")
+    endif()
+
+    get_target_property(tool obfuscxx::levels ALIASED_TARGET)
+    if(NOT tool)
+        set(tool obfuscxx::levels)
+    endif()
+
+    set(profiles "")
+    foreach(profile IN LISTS ARG_PROFILE)
+        get_filename_component(profile "${profile}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+        if(NOT EXISTS "${profile}")
+            message(FATAL_ERROR "obfuscxx_level_overrides: profile ${profile} does not exist")
+        endif()
+        list(APPEND profiles "${profile}")
+    endforeach()
+
+    set(output "${CMAKE_CURRENT_BINARY_DIR}/obfuscxx_levels/${target}.h")
+    set(args "${output}" ${profiles})
+    if(ARG_HOT_PERCENT)
+        list(APPEND args --hot "${ARG_HOT_PERCENT}")
+    endif()
+    if(ARG_LEVEL)
+        list(APPEND args --level "${ARG_LEVEL}")
+    endif()
+
+    add_custom_command(
+            OUTPUT "${output}"
+            COMMAND "${CMAKE_COMMAND}" -E make_directory "${CMAKE_CURRENT_BINARY_DIR}/obfuscxx_levels"
+            COMMAND "$<TARGET_FILE:${tool}>" ${args}
+            DEPENDS ${profiles} ${tool}
+            COMMENT "Generating obfuscxx level overrides for ${target}"
+            VERBATIM
+    )
+
+    _obfuscxx_profile_seed(${target} seed SEED "${ARG_SEED}")
+    target_sources(${target} PRIVATE "${output}")
+    target_compile_definitions(${target} PRIVATE OBFUSCXX_LEVEL_OVERRIDES="${output}" OBFUSCXX_ENTROPY_SEED=${seed})
+endfunction()
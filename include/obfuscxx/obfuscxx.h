@@ -27,6 +27,36 @@ using max_align_t = double;
 #endif
 
 #include <type_traits>
+#include <utility>
+
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
+#endif
+
+#if defined(OBFUSCXX_PROFILE)
+#if defined(_KERNEL_MODE) || defined(_WIN64_DRIVER)
+#error "OBFUSCXX_PROFILE is not available in kernel mode"
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <source_location>
+#endif
+
+#if defined(OBFUSCXX_TRACE)
+#if defined(_KERNEL_MODE) || defined(_WIN64_DRIVER)
+#error "OBFUSCXX_TRACE is not available in kernel mode"
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
 
 #if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
 #include <arm_neon.h>
@@ -34,7 +64,6 @@ using max_align_t = double;
 #include <intrin.h>
 #elif defined(__GNUC__) || defined(__clang__)
 #include <immintrin.h>
-#include <cpuid.h>
 #else
 #error Unsupported platform
 #endif
@@ -47,6 +76,22 @@ using max_align_t = double;
 #define OBFUSCXX_HAS_AVX2 0
 #endif
 
+#if defined(__AVX512F__) && OBFUSCXX_HAS_AVX2
+#define OBFUSCXX_HAS_AVX512 1
+#else
+#define OBFUSCXX_HAS_AVX512 0
+#endif
+
+// Runtime dispatch is opt-in: it compiles in the AVX-512F kernel, so every array is padded to 16 blocks on a 64-byte
+// boundary even on hosts that never run it.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__)) &&   \
+    !OBFUSCXX_HAS_AVX512 && defined(OBFUSCXX_ENABLE_DISPATCH) && !defined(OBFUSCXX_DISABLE_DISPATCH) &&                \
+    !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+#define OBFUSCXX_HAS_DISPATCH 1
+#else
+#define OBFUSCXX_HAS_DISPATCH 0
+#endif
+
 #if defined(__clang__) || defined(__GNUC__)
 #define OBFUSCXX_VOLATILE
 #elif defined(_MSC_VER)
@@ -55,8 +100,28 @@ using max_align_t = double;
 
 #if defined(__clang__) || defined(__GNUC__)
 #define OBFUSCXX_FORCEINLINE __attribute__((always_inline)) inline
+#define OBFUSCXX_NOINLINE __attribute__((noinline))
 #else
 #define OBFUSCXX_FORCEINLINE __forceinline
+#define OBFUSCXX_NOINLINE __declspec(noinline)
+#endif
+
+#if OBFUSCXX_HAS_DISPATCH && !OBFUSCXX_HAS_AVX2
+#define OBFUSCXX_INLINE_AVX2 __attribute__((target("avx2"))) inline
+#else
+#define OBFUSCXX_INLINE_AVX2 OBFUSCXX_FORCEINLINE
+#endif
+
+#if OBFUSCXX_HAS_DISPATCH
+#define OBFUSCXX_INLINE_AVX512 __attribute__((target("avx512f"))) inline
+#define OBFUSCXX_KERNEL_AVX2 __attribute__((target("avx2"), flatten))
+#define OBFUSCXX_KERNEL_AVX512 __attribute__((target("avx512f"), flatten))
+#define OBFUSCXX_OUTLINED_AVX2 __attribute__((target("avx2"), noinline))
+#define OBFUSCXX_OUTLINED_AVX512 __attribute__((target("avx512f"), noinline))
+#else
+#define OBFUSCXX_INLINE_AVX512 OBFUSCXX_FORCEINLINE
+#define OBFUSCXX_OUTLINED_AVX2 OBFUSCXX_NOINLINE
+#define OBFUSCXX_OUTLINED_AVX512 OBFUSCXX_NOINLINE
 #endif
 
 #if defined(_KERNEL_MODE) || defined(_WIN64_DRIVER)
@@ -83,6 +148,13 @@ using max_align_t = double;
 #define OBFUSCXX_RUNTIME_WARNING
 #endif
 
+#if OBFUSCXX_HAS_DISPATCH
+// Dispatched kernels pass wide vectors between functions with different target attributes; they are always
+// flattened into the kernel, so the ABI note about non-AVX callers does not apply.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
 namespace ngu {
     namespace detail {
         constexpr std::uint64_t splitmix64(std::uint64_t x) {
@@ -107,7 +179,7 @@ namespace ngu {
             return hash;
         }
 
-        OBFUSCXX_FORCEINLINE std::uint64_t hash_runtime(char const* str) {
+        OBFUSCXX_FORCEINLINE constexpr std::uint64_t hash_runtime(char const* str) {
             std::size_t length = 0;
             while (str[length] != 0) {
                 ++length;
@@ -165,6 +237,18 @@ namespace ngu {
         static OBFUSCXX_FORCEINLINE vec vsub(vec a, vec b) {
             return vsubq_u32(a, b);
         }
+        static OBFUSCXX_FORCEINLINE vec vand(vec a, vec b) {
+            return vandq_u32(a, b);
+        }
+        template<int N> static OBFUSCXX_FORCEINLINE vec rotl(vec v) {
+            return vsriq_n_u32(vshlq_n_u32(v, N), v, 32 - N);
+        }
+        template<int N> static OBFUSCXX_FORCEINLINE vec rotr(vec v) {
+            return rotl<32 - N>(v);
+        }
+        static OBFUSCXX_FORCEINLINE vec load(const std::uint32_t* src) {
+            return vld1q_u32(src);
+        }
         static OBFUSCXX_FORCEINLINE vec broadcast(std::uint32_t v) {
             return vdupq_n_u32(v);
         }
@@ -174,6 +258,18 @@ namespace ngu {
         static OBFUSCXX_FORCEINLINE std::uint32_t to_scalar(vec v) {
             return vgetq_lane_u32(v, 0);
         }
+
+        static constexpr std::size_t lanes = 4;
+        static OBFUSCXX_FORCEINLINE void load_blocks(const std::uint64_t* src, vec& v0, vec& v1) {
+            uint32x4x2_t const loaded = vld2q_u32(reinterpret_cast<const std::uint32_t*>(src));
+            v0 = loaded.val[0];
+            v1 = loaded.val[1];
+        }
+        static OBFUSCXX_FORCEINLINE void store_blocks(std::uint64_t* dst, vec v0, vec v1) {
+            uint32x4x2_t const zipped = vzipq_u32(v0, v1);
+            vst1q_u32(reinterpret_cast<std::uint32_t*>(&dst[0]), zipped.val[0]);
+            vst1q_u32(reinterpret_cast<std::uint32_t*>(&dst[2]), zipped.val[1]);
+        }
     };
 #else
     template<> struct simd<__m128i> {
@@ -193,6 +289,18 @@ namespace ngu {
         static OBFUSCXX_FORCEINLINE vec vsub(vec a, vec b) {
             return _mm_sub_epi32(a, b);
         }
+        static OBFUSCXX_FORCEINLINE vec vand(vec a, vec b) {
+            return _mm_and_si128(a, b);
+        }
+        template<int N> static OBFUSCXX_FORCEINLINE vec rotl(vec v) {
+            return _mm_or_si128(_mm_slli_epi32(v, N), _mm_srli_epi32(v, 32 - N));
+        }
+        template<int N> static OBFUSCXX_FORCEINLINE vec rotr(vec v) {
+            return rotl<32 - N>(v);
+        }
+        static OBFUSCXX_FORCEINLINE vec load(const std::uint32_t* src) {
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(src));
+        }
         static OBFUSCXX_FORCEINLINE vec broadcast(std::uint32_t v) {
             return _mm_set1_epi32(v);
         }
@@ -202,38 +310,224 @@ namespace ngu {
         static OBFUSCXX_FORCEINLINE std::uint32_t to_scalar(vec v) {
             return _mm_cvtsi128_si32(v);
         }
+
+        static constexpr std::size_t lanes = 4;
+        static OBFUSCXX_FORCEINLINE void load_blocks(const std::uint64_t* src, vec& v0, vec& v1) {
+            const auto* p = reinterpret_cast<const __m128i*>(src);
+
+            __m128i const d0 = _mm_load_si128(p);
+            __m128i const d1 = _mm_load_si128(p + 1);
+            __m128i const mask = _mm_set1_epi64x(0xFFFFFFFF);
+            v0 = _mm_castps_si128(_mm_shuffle_ps(
+                _mm_castsi128_ps(_mm_and_si128(d0, mask)),
+                _mm_castsi128_ps(_mm_and_si128(d1, mask)),
+                _MM_SHUFFLE(2, 0, 2, 0)
+            ));
+            v1 = _mm_castps_si128(_mm_shuffle_ps(
+                _mm_castsi128_ps(_mm_srli_epi64(d0, 32)),
+                _mm_castsi128_ps(_mm_srli_epi64(d1, 32)),
+                _MM_SHUFFLE(2, 0, 2, 0)
+            ));
+        }
+        static OBFUSCXX_FORCEINLINE void store_blocks(std::uint64_t* dst, vec v0, vec v1) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(&dst[0]), _mm_unpacklo_epi32(v0, v1));
+            _mm_store_si128(reinterpret_cast<__m128i*>(&dst[2]), _mm_unpackhi_epi32(v0, v1));
+        }
     };
-#if OBFUSCXX_HAS_AVX2
+#if OBFUSCXX_HAS_AVX2 || OBFUSCXX_HAS_DISPATCH
     template<> struct simd<__m256i> {
         using vec = __m256i;
-        static OBFUSCXX_FORCEINLINE vec shl4(vec v) {
+        static OBFUSCXX_INLINE_AVX2 vec shl4(vec v) {
             return _mm256_slli_epi32(v, 4);
         }
-        static OBFUSCXX_FORCEINLINE vec shr5(vec v) {
+        static OBFUSCXX_INLINE_AVX2 vec shr5(vec v) {
             return _mm256_srli_epi32(v, 5);
         }
-        static OBFUSCXX_FORCEINLINE vec vxor(vec a, vec b) {
+        static OBFUSCXX_INLINE_AVX2 vec vxor(vec a, vec b) {
             return _mm256_xor_si256(a, b);
         }
-        static OBFUSCXX_FORCEINLINE vec vadd(vec a, vec b) {
+        static OBFUSCXX_INLINE_AVX2 vec vadd(vec a, vec b) {
             return _mm256_add_epi32(a, b);
         }
-        static OBFUSCXX_FORCEINLINE vec vsub(vec a, vec b) {
+        static OBFUSCXX_INLINE_AVX2 vec vsub(vec a, vec b) {
             return _mm256_sub_epi32(a, b);
         }
-        static OBFUSCXX_FORCEINLINE vec broadcast(std::uint32_t v) {
+        static OBFUSCXX_INLINE_AVX2 vec vand(vec a, vec b) {
+            return _mm256_and_si256(a, b);
+        }
+        // Byte-sized rotates are a single shuffle instead of two shifts and an or.
+        template<int N> static OBFUSCXX_INLINE_AVX2 vec rotl(vec v) {
+            if constexpr (N == 8) {
+                return _mm256_shuffle_epi8(
+                    v, _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                        3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14)
+                );
+            } else if constexpr (N == 24) {
+                return _mm256_shuffle_epi8(
+                    v, _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                        1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12)
+                );
+            } else {
+                return _mm256_or_si256(_mm256_slli_epi32(v, N), _mm256_srli_epi32(v, 32 - N));
+            }
+        }
+        template<int N> static OBFUSCXX_INLINE_AVX2 vec rotr(vec v) {
+            return rotl<32 - N>(v);
+        }
+        static OBFUSCXX_INLINE_AVX2 vec load(const std::uint32_t* src) {
+            return _mm256_load_si256(reinterpret_cast<const __m256i*>(src));
+        }
+        static OBFUSCXX_INLINE_AVX2 vec broadcast(std::uint32_t v) {
             return _mm256_set1_epi32(v);
         }
-        static OBFUSCXX_FORCEINLINE vec from_scalar(std::uint32_t v) {
+        static OBFUSCXX_INLINE_AVX2 vec from_scalar(std::uint32_t v) {
             return _mm256_set1_epi32(v);
         }
-        static OBFUSCXX_FORCEINLINE std::uint32_t to_scalar(vec v) {
+        static OBFUSCXX_INLINE_AVX2 std::uint32_t to_scalar(vec v) {
             return _mm256_extract_epi32(v, 0);
         }
+
+        static constexpr std::size_t lanes = 8;
+        static OBFUSCXX_INLINE_AVX2 void load_blocks(const std::uint64_t* src, vec& v0, vec& v1) {
+            const auto* p = reinterpret_cast<const __m256i*>(src);
+
+            __m256i const d0 = _mm256_load_si256(p);
+            __m256i const d1 = _mm256_load_si256(p + 1);
+            __m256i const perm_even = _mm256_set_epi32(0, 0, 0, 0, 6, 4, 2, 0);
+            __m256i const perm_odd = _mm256_set_epi32(0, 0, 0, 0, 7, 5, 3, 1);
+            v0 = _mm256_permute2x128_si256(
+                _mm256_permutevar8x32_epi32(d0, perm_even), _mm256_permutevar8x32_epi32(d1, perm_even), 0x20
+            );
+            v1 = _mm256_permute2x128_si256(
+                _mm256_permutevar8x32_epi32(d0, perm_odd), _mm256_permutevar8x32_epi32(d1, perm_odd), 0x20
+            );
+        }
+        static OBFUSCXX_INLINE_AVX2 void store_blocks(std::uint64_t* dst, vec v0, vec v1) {
+            __m128i const v0_128lo = _mm256_castsi256_si128(v0);
+            __m128i const v1_128lo = _mm256_castsi256_si128(v1);
+            __m128i const v0_128hi = _mm256_extracti128_si256(v0, 1);
+            __m128i const v1_128hi = _mm256_extracti128_si256(v1, 1);
+
+            _mm_store_si128(reinterpret_cast<__m128i*>(&dst[0]), _mm_unpacklo_epi32(v0_128lo, v1_128lo));
+            _mm_store_si128(reinterpret_cast<__m128i*>(&dst[2]), _mm_unpackhi_epi32(v0_128lo, v1_128lo));
+            _mm_store_si128(reinterpret_cast<__m128i*>(&dst[4]), _mm_unpacklo_epi32(v0_128hi, v1_128hi));
+            _mm_store_si128(reinterpret_cast<__m128i*>(&dst[6]), _mm_unpackhi_epi32(v0_128hi, v1_128hi));
+        }
+    };
+#endif
+#if OBFUSCXX_HAS_AVX512 || OBFUSCXX_HAS_DISPATCH
+    template<> struct simd<__m512i> {
+        using vec = __m512i;
+        // The zero-masked forms avoid GCC 12's false -Wmaybe-uninitialized in the unmasked intrinsics.
+        static OBFUSCXX_INLINE_AVX512 vec shl4(vec v) {
+            return _mm512_maskz_slli_epi32(0xFFFF, v, 4);
+        }
+        static OBFUSCXX_INLINE_AVX512 vec shr5(vec v) {
+            return _mm512_maskz_srli_epi32(0xFFFF, v, 5);
+        }
+        static OBFUSCXX_INLINE_AVX512 vec vxor(vec a, vec b) {
+            return _mm512_xor_si512(a, b);
+        }
+        static OBFUSCXX_INLINE_AVX512 vec vadd(vec a, vec b) {
+            return _mm512_add_epi32(a, b);
+        }
+        static OBFUSCXX_INLINE_AVX512 vec vsub(vec a, vec b) {
+            return _mm512_sub_epi32(a, b);
+        }
+        static OBFUSCXX_INLINE_AVX512 vec vand(vec a, vec b) {
+            return _mm512_and_si512(a, b);
+        }
+        template<int N> static OBFUSCXX_INLINE_AVX512 vec rotl(vec v) {
+            return _mm512_maskz_rol_epi32(0xFFFF, v, N);
+        }
+        template<int N> static OBFUSCXX_INLINE_AVX512 vec rotr(vec v) {
+            return _mm512_maskz_ror_epi32(0xFFFF, v, N);
+        }
+        static OBFUSCXX_INLINE_AVX512 vec load(const std::uint32_t* src) {
+            return _mm512_load_si512(src);
+        }
+        static OBFUSCXX_INLINE_AVX512 vec broadcast(std::uint32_t v) {
+            return _mm512_set1_epi32(static_cast<int>(v));
+        }
+        static OBFUSCXX_INLINE_AVX512 vec from_scalar(std::uint32_t v) {
+            return _mm512_set1_epi32(static_cast<int>(v));
+        }
+        static OBFUSCXX_INLINE_AVX512 std::uint32_t to_scalar(vec v) {
+            return _mm_cvtsi128_si32(_mm512_castsi512_si128(v));
+        }
+
+        static constexpr std::size_t lanes = 16;
+        static OBFUSCXX_INLINE_AVX512 void load_blocks(const std::uint64_t* src, vec& v0, vec& v1) {
+            const auto* p = reinterpret_cast<const __m512i*>(src);
+
+            __m512i const d0 = _mm512_load_si512(p);
+            __m512i const d1 = _mm512_load_si512(p + 1);
+            __m512i const perm_even = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+            __m512i const perm_odd = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+            v0 = _mm512_permutex2var_epi32(d0, perm_even, d1);
+            v1 = _mm512_permutex2var_epi32(d0, perm_odd, d1);
+        }
+        static OBFUSCXX_INLINE_AVX512 void store_blocks(std::uint64_t* dst, vec v0, vec v1) {
+            __m512i const zip_lo = _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0);
+            __m512i const zip_hi = _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8);
+
+            _mm512_store_si512(&dst[0], _mm512_permutex2var_epi32(v0, zip_lo, v1));
+            _mm512_store_si512(&dst[8], _mm512_permutex2var_epi32(v0, zip_hi, v1));
+        }
     };
 #endif
 #endif
 
+    enum class simd_kernel : std::uint8_t { Sse2, Avx2, Avx512, Neon };
+
+    namespace detail {
+        inline simd_kernel select_kernel() {
+#if defined(__aarch64__) || defined(_M_ARM64)
+            return simd_kernel::Neon;
+#elif OBFUSCXX_HAS_AVX512
+            return simd_kernel::Avx512;
+#elif OBFUSCXX_HAS_DISPATCH
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return simd_kernel::Avx512;
+            }
+            if (OBFUSCXX_HAS_AVX2 || __builtin_cpu_supports("avx2")) {
+                return simd_kernel::Avx2;
+            }
+            return simd_kernel::Sse2;
+#elif OBFUSCXX_HAS_AVX2
+#if defined(_MSC_VER) && !defined(__clang__) && !defined(OBFUSCXX_MSVC_FORCE_AVX2)
+            int cpu_info[4]{};
+            __cpuidex(cpu_info, 7, 0);
+            return (cpu_info[1] & (1 << 5)) != 0 ? simd_kernel::Avx2 : simd_kernel::Sse2;
+#else
+            return simd_kernel::Avx2;
+#endif
+#else
+            return simd_kernel::Sse2;
+#endif
+        }
+    } // namespace detail
+
+    inline simd_kernel active_kernel() {
+        static const simd_kernel cached = detail::select_kernel();
+        return cached;
+    }
+
+    constexpr const char* kernel_name(simd_kernel kernel) {
+        switch (kernel) {
+        case simd_kernel::Sse2:
+            return "sse2";
+        case simd_kernel::Avx2:
+            return "avx2";
+        case simd_kernel::Avx512:
+            return "avx512f";
+        case simd_kernel::Neon:
+            return "neon";
+        }
+        return "unknown";
+    }
+
 #define OBFUSCXX_HASH(s) detail::hash_compile_time(s)
 #define OBFUSCXX_HASH_RT(s) detail::hash_runtime(s)
 
@@ -244,613 +538,3042 @@ namespace ngu {
         (detail::rol64((std::uint64_t)__COUNTER__, 37) ^ ((std::uint64_t)__LINE__ * 0xff51afd7ed558ccdULL))            \
     ))
 #else
+// Per-build part of the entropy. Defining OBFUSCXX_ENTROPY_SEED makes keys reproducible across builds, which
+// profile-guided level overrides rely on to recognize instantiations.
+#if defined(OBFUSCXX_ENTROPY_SEED)
+#define OBFUSCXX_BUILD_ENTROPY ((std::uint64_t)(OBFUSCXX_ENTROPY_SEED))
+#else
+#define OBFUSCXX_BUILD_ENTROPY OBFUSCXX_HASH(__TIME__)
+#endif
+
 #define OBFUSCXX_ENTROPY                                                                                               \
     (detail::splitmix64(                                                                                               \
         OBFUSCXX_HASH(__FILE__) + ((std::uint64_t)__LINE__ * 0x9e3779b97f4a7c15ULL) +                                  \
-        (OBFUSCXX_HASH(__TIME__) ^ ((std::uint64_t)__COUNTER__ << 32))                                                 \
+        (OBFUSCXX_BUILD_ENTROPY ^ ((std::uint64_t)__COUNTER__ << 32))                                                  \
     ))
 #endif
 
     enum class obf_level : std::uint8_t { Low, Medium, High };
-    template<
-        class Type,
-        std::size_t Size = 1,
-        obf_level Level = obf_level::Low,
-        std::uint64_t Entropy = OBFUSCXX_ENTROPY>
-    class obfuscxx {
-        static constexpr bool is_single = Size == 1;
-        static constexpr bool is_array = Size > 1;
-        static constexpr bool is_single_pointer = std::is_pointer_v<Type> && Size == 1;
-        static constexpr bool is_char = std::is_same_v<Type, char> || std::is_same_v<Type, const char>;
-        static constexpr bool is_wchar = std::is_same_v<Type, wchar_t> || std::is_same_v<Type, const wchar_t>;
-
-        static constexpr std::size_t storage_multiple = OBFUSCXX_HAS_AVX2 ? 8 : 4;
-        static constexpr std::size_t storage_alignment = OBFUSCXX_HAS_AVX2 ? 32 : 16;
-        static constexpr std::size_t storage_size =
-            is_array ? (Size + storage_multiple - 1) & ~(storage_multiple - 1) : Size;
-
-        struct passkey {
-            explicit passkey() = default;
-        };
 
-        static constexpr std::uint64_t seed{Entropy};
-        static constexpr std::uint64_t iv[8] = {
-            0xcbf43b227a01fe5aULL ^ seed,
-            0x32703be7aaa7c38fULL ^ detail::ror64(seed, 13),
-            0xb589959b3d854bbcULL ^ detail::rol64(seed, 29),
-            0x73b3ef5578a97c8aULL ^ detail::ror64(seed, 41),
-            0x92afafd27c6e16e9ULL ^ detail::rol64(seed, 7),
-            0xee8291ae3070720aULL ^ detail::ror64(seed, 53),
-            0xe2c0d70f73d6c4a0ULL ^ detail::rol64(seed, 19),
-            0x82742897b912855bULL ^ detail::ror64(seed, 37),
+    namespace detail {
+        // XTEA parameters of an instance, derived from its Entropy and Level. Plain constexpr rather than consteval so
+        // build tools can produce ciphertext for a given entropy at run time (see tools/obfuscxx_embed.cpp).
+        struct xtea_key {
+            std::uint64_t seed;
+            std::uint64_t iv[8];
+            std::uint32_t rounds;
+            std::uint32_t delta;
         };
-        static constexpr std::uint64_t iv_size = (sizeof(iv) / 8) - 1;
-        static constexpr std::uint64_t unique_index = seed & iv_size;
-        static constexpr std::uint64_t unique_value = iv[unique_index];
-
-        static constexpr std::uint32_t xtea_rounds = (Level == obf_level::Low)      ? 2
-                                                     : (Level == obf_level::Medium) ? 6
-                                                                                    : (8 + ((unique_value % 13) * 2));
-
-        static constexpr std::uint32_t xtea_delta = (0x9E3779B9 ^ static_cast<std::uint32_t>(unique_value)) | 1;
-
-        static constexpr std::uint64_t encrypt(Type value) {
-            std::uint64_t val = to_uint64(value);
 
+        constexpr xtea_key make_xtea_key(std::uint64_t entropy, obf_level level) {
+            xtea_key key{
+                entropy,
+                {
+                    0xcbf43b227a01fe5aULL ^ entropy,
+                    0x32703be7aaa7c38fULL ^ ror64(entropy, 13),
+                    0xb589959b3d854bbcULL ^ rol64(entropy, 29),
+                    0x73b3ef5578a97c8aULL ^ ror64(entropy, 41),
+                    0x92afafd27c6e16e9ULL ^ rol64(entropy, 7),
+                    0xee8291ae3070720aULL ^ ror64(entropy, 53),
+                    0xe2c0d70f73d6c4a0ULL ^ rol64(entropy, 19),
+                    0x82742897b912855bULL ^ ror64(entropy, 37),
+                },
+                0,
+                0,
+            };
+
+            std::uint64_t const unique_value = key.iv[entropy & 7];
+            key.rounds = (level == obf_level::Low)      ? 2
+                         : (level == obf_level::Medium) ? 6
+                                                        : static_cast<std::uint32_t>(8 + ((unique_value % 13) * 2));
+            key.delta = (0x9E3779B9 ^ static_cast<std::uint32_t>(unique_value)) | 1;
+            return key;
+        }
+
+        constexpr std::uint64_t xtea_encrypt(const xtea_key& key, std::uint64_t val) {
             std::uint32_t v0 = static_cast<std::uint32_t>(val);
             std::uint32_t v1 = static_cast<std::uint32_t>(val >> 32);
             std::uint32_t sum = 0;
 
-            for (std::uint32_t i{}; i < xtea_rounds; ++i) {
-                v0 += (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + static_cast<std::uint32_t>(iv[sum & 3]));
-                sum += xtea_delta;
-                v1 += (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + static_cast<std::uint32_t>(iv[(sum >> 11) & 3]));
+            for (std::uint32_t i{}; i < key.rounds; ++i) {
+                v0 += (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + static_cast<std::uint32_t>(key.iv[sum & 3]));
+                sum += key.delta;
+                v1 += (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + static_cast<std::uint32_t>(key.iv[(sum >> 11) & 3]));
             }
 
             return (static_cast<std::uint64_t>(v1) << 32) | v0;
         }
 
-        template<typename Vec> static OBFUSCXX_FORCEINLINE Vec xtea_half_round(Vec va, Vec vb, std::uint32_t key_val) {
-            using S = simd<Vec>;
-            auto left = S::shl4(va);
-            auto right = S::shr5(va);
-            auto temp = S::vxor(left, right);
-            temp = S::vadd(temp, va);
-            auto key = S::broadcast(key_val);
-            temp = S::vxor(temp, key);
-            return S::vsub(vb, temp);
-        }
-
-        template<typename Vec> static OBFUSCXX_FORCEINLINE Type decrypt_scalar(std::uint32_t v0, std::uint32_t v1) {
-            using S = simd<Vec>;
-            auto sv0 = S::from_scalar(v0);
-            auto sv1 = S::from_scalar(v1);
-
-            decrypt_rounds(sv0, sv1);
+        // SPECK 64/128 round keys of an instance. Standard SPECK 64/128 uses 27 rounds; Low and Medium trade rounds
+        // for latency like XTEA does, High adds up to seven more depending on the entropy.
+        struct speck_key {
+            std::uint32_t rounds;
+            std::uint32_t k[34];
+        };
 
-            v0 = S::to_scalar(sv0);
-            v1 = S::to_scalar(sv1);
-            return from_uint64((static_cast<std::uint64_t>(v1) << 32) | v0);
+        constexpr std::uint32_t rol32(std::uint32_t x, int n) {
+            return (x << n) | (x >> (32 - n));
         }
 
-        template<typename Vec> static OBFUSCXX_FORCEINLINE void decrypt_rounds(Vec& v0_vec, Vec& v1_vec) {
-            std::uint32_t sum = xtea_delta * xtea_rounds;
+        constexpr std::uint32_t ror32(std::uint32_t x, int n) {
+            return (x >> n) | (x << (32 - n));
+        }
 
-            for (std::uint32_t i{}; i < xtea_rounds; ++i) {
-                OBFUSCXX_MEM_BARRIER_VEC(v0_vec, v1_vec, sum)
-                v1_vec = xtea_half_round(v0_vec, v1_vec, sum + static_cast<std::uint32_t>(iv[(sum >> 11) & 3]));
-                sum -= xtea_delta;
-                OBFUSCXX_MEM_BARRIER_VEC(v0_vec, v1_vec, sum)
-                v0_vec = xtea_half_round(v1_vec, v0_vec, sum + static_cast<std::uint32_t>(iv[sum & 3]));
+        // Standard SPECK 64/128 key expansion of the key words (l2, l1, l0, k0).
+        constexpr speck_key expand_speck_key(
+            std::uint32_t k0, std::uint32_t l0, std::uint32_t l1, std::uint32_t l2, std::uint32_t rounds
+        ) {
+            speck_key key{rounds, {k0}};
+            std::uint32_t l[3 + 34]{l0, l1, l2};
+            for (std::uint32_t i{}; i + 1 < rounds; ++i) {
+                l[i + 3] = (key.k[i] + ror32(l[i], 8)) ^ i;
+                key.k[i + 1] = rol32(key.k[i], 3) ^ l[i + 3];
+            }
+            return key;
+        }
+
+        constexpr speck_key make_speck_key(std::uint64_t entropy, obf_level level) {
+            std::uint64_t const a = splitmix64(entropy ^ 0x5bd1e9955bd1e995ULL);
+            std::uint64_t const b = splitmix64(a);
+            std::uint32_t const rounds = (level == obf_level::Low)      ? 3
+                                         : (level == obf_level::Medium) ? 8
+                                                                        : 27 + static_cast<std::uint32_t>(b >> 61);
+            return expand_speck_key(
+                static_cast<std::uint32_t>(a),
+                static_cast<std::uint32_t>(a >> 32),
+                static_cast<std::uint32_t>(b),
+                static_cast<std::uint32_t>(b >> 32),
+                rounds
+            );
+        }
+
+        constexpr std::uint64_t speck_encrypt(const speck_key& key, std::uint64_t val) {
+            auto y = static_cast<std::uint32_t>(val);
+            auto x = static_cast<std::uint32_t>(val >> 32);
+
+            for (std::uint32_t i{}; i < key.rounds; ++i) {
+                x = (ror32(x, 8) + y) ^ key.k[i];
+                y = rol32(y, 3) ^ x;
             }
+
+            return (static_cast<std::uint64_t>(x) << 32) | y;
         }
 
-        static OBFUSCXX_FORCEINLINE Type decrypt(std::uint64_t value) {
-            OBFUSCXX_MEM_BARRIER(value)
+        // Per-lane block offsets for generating counter vectors.
+        alignas(64) inline constexpr std::uint32_t lane_ids[16] = {
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+        };
 
-            auto const v0 = static_cast<std::uint32_t>(value);
-            auto const v1 = static_cast<std::uint32_t>(value >> 32);
+        template<class... Objs> struct batch_decryptor;
+    } // namespace detail
 
-#if defined(__aarch64__) || defined(_M_ARM64)
-            return decrypt_scalar<uint32x4_t>(v0, v1);
-#elif OBFUSCXX_HAS_AVX2
-#if defined(_MSC_VER) && !defined(__clang__) && !defined(OBFUSCXX_MSVC_FORCE_AVX2)
-            if (cpu_has_avx2()) {
-                return decrypt_scalar<__m256i>(v0, v1);
+    // Cipher policies for the Cipher parameter of obfuscxx. engine<Level, Entropy> provides the constexpr block
+    // encryptor used by the consteval constructors and the vector rounds used by the SIMD kernels. The rounds keep a
+    // compiler barrier between steps so the decryption of constant data cannot be folded at compile time.
+    struct xtea {
+        template<bool Encrypt = false, typename Vec>
+        static OBFUSCXX_FORCEINLINE void half_round(const Vec& va, Vec& vb, std::uint32_t key_val) {
+            using S = simd<Vec>;
+            auto left = S::shl4(va);
+            auto right = S::shr5(va);
+            auto temp = S::vxor(left, right);
+            temp = S::vadd(temp, va);
+            auto round_key = S::broadcast(key_val);
+            temp = S::vxor(temp, round_key);
+            if constexpr (Encrypt) {
+                vb = S::vadd(vb, temp);
+            } else {
+                vb = S::vsub(vb, temp);
             }
-            return decrypt_scalar<__m128i>(v0, v1);
-#else
-            return decrypt_scalar<__m256i>(v0, v1);
-#endif
-#else
-            return decrypt_scalar<__m128i>(v0, v1);
-#endif
         }
 
-        static OBFUSCXX_FORCEINLINE void decrypt_vectorized(
-            const volatile std::uint64_t* src, Type* dst, std::size_t count
-        ) {
-            std::size_t const aligned_count = (count + storage_multiple - 1) & ~(storage_multiple - 1);
+        template<obf_level Level, std::uint64_t Entropy> struct engine {
+            static constexpr detail::xtea_key key = detail::make_xtea_key(Entropy, Level);
+            static constexpr std::uint32_t rounds = key.rounds;
+            static constexpr std::uint32_t delta = key.delta;
+            static constexpr bool counter_mode = false;
 
-#if defined(__aarch64__) || defined(_M_ARM64)
-            for (std::size_t i{}; i < aligned_count; i += 4) {
-                uint32x4x2_t loaded =
-                    vld2q_u32(reinterpret_cast<const std::uint32_t*>(const_cast<const std::uint64_t*>(src + i)));
-                uint32x4_t v0_vec = loaded.val[0];
-                uint32x4_t v1_vec = loaded.val[1];
+            static constexpr std::uint64_t encrypt(std::uint64_t block) {
+                return detail::xtea_encrypt(key, block);
+            }
+
+            // Key mixed into the step-th half round of decrypt_rounds(), counting from zero.
+            static constexpr std::uint32_t decrypt_round_key(std::uint32_t step) {
+                std::uint32_t const sum = delta * (rounds - ((step + 1) / 2));
+                return sum + static_cast<std::uint32_t>(key.iv[(step & 1) != 0 ? sum & 3 : (sum >> 11) & 3]);
+            }
 
-                decrypt_rounds(v0_vec, v1_vec);
+            // Key mixed into the step-th half round of encrypt_rounds(), counting from zero.
+            static constexpr std::uint32_t encrypt_round_key(std::uint32_t step) {
+                std::uint32_t const sum = delta * ((step + 1) / 2);
+                return sum + static_cast<std::uint32_t>(key.iv[(step & 1) != 0 ? (sum >> 11) & 3 : sum & 3]);
+            }
 
-                uint32x4x2_t zipped = vzipq_u32(v0_vec, v1_vec);
-                alignas(16) std::uint64_t out64[4];
-                vst1q_u32(reinterpret_cast<std::uint32_t*>(&out64[0]), zipped.val[0]);
-                vst1q_u32(reinterpret_cast<std::uint32_t*>(&out64[2]), zipped.val[1]);
+            // Per half round keys in issue order, so a half round costs one load instead of the sum update, table
+            // lookup and add on the dependency chain. The loops stay rolled: unrolling every call site over all the
+            // steps multiplies the inlined code by the round count and costs more in i-cache than it saves.
+            struct round_schedule {
+                std::uint32_t decrypt[rounds * 2];
+                std::uint32_t encrypt[rounds * 2];
+            };
+
+            static constexpr round_schedule schedule = [] {
+                round_schedule result{};
+                for (std::uint32_t step{}; step < rounds * 2; ++step) {
+                    result.decrypt[step] = decrypt_round_key(step);
+                    result.encrypt[step] = encrypt_round_key(step);
+                }
+                return result;
+            }();
 
-                for (std::size_t j{}; j < 4 && (i + j) < count; ++j) {
-                    dst[i + j] = from_uint64(out64[j]);
+            // The barrier ties each key to the vectors it is applied to, which keeps the schedule from being folded
+            // into the ciphertext of constant data just as the running sum did.
+            template<bool Encrypt, bool Odd, typename Pair>
+            static OBFUSCXX_FORCEINLINE void half_step(Pair& pair, std::uint32_t key_val) {
+                OBFUSCXX_MEM_BARRIER_VEC(pair.v0, pair.v1, key_val)
+                if constexpr (Odd != Encrypt) {
+                    half_round<Encrypt>(pair.v1, pair.v0, key_val);
+                } else {
+                    half_round<Encrypt>(pair.v0, pair.v1, key_val);
                 }
             }
 
-#elif OBFUSCXX_HAS_AVX2
-#if defined(_MSC_VER) && !defined(__clang__) && !defined(OBFUSCXX_MSVC_FORCE_AVX2)
-            if (cpu_has_avx2()) {
-#endif
-                for (std::size_t i{}; i < aligned_count; i += 8) {
-                    const auto* p = reinterpret_cast<const __m256i*>(const_cast<const std::uint64_t*>(src + i));
+            // Every pair keeps its own barriers, but the half rounds of all pairs are issued back to back so their
+            // dependency chains overlap. The pairs are separate locals rather than an array so they stay in registers
+            // across the barriers.
+            template<bool Encrypt, typename... Pairs> static OBFUSCXX_FORCEINLINE void run(Pairs&... pairs) {
+                const std::uint32_t* keys = Encrypt ? schedule.encrypt : schedule.decrypt;
+                for (std::uint32_t step{}; step < rounds * 2; step += 2) {
+                    (half_step<Encrypt, false>(pairs, keys[step]), ...);
+                    (half_step<Encrypt, true>(pairs, keys[step + 1]), ...);
+                }
+            }
 
-                    __m256i d0 = _mm256_load_si256(p);
-                    __m256i d1 = _mm256_load_si256(p + 1);
-                    __m256i perm_even = _mm256_set_epi32(0, 0, 0, 0, 6, 4, 2, 0);
-                    __m256i perm_odd = _mm256_set_epi32(0, 0, 0, 0, 7, 5, 3, 1);
-                    __m256i v0_vec = _mm256_permute2x128_si256(
-                        _mm256_permutevar8x32_epi32(d0, perm_even), _mm256_permutevar8x32_epi32(d1, perm_even), 0x20
-                    );
-                    __m256i v1_vec = _mm256_permute2x128_si256(
-                        _mm256_permutevar8x32_epi32(d0, perm_odd), _mm256_permutevar8x32_epi32(d1, perm_odd), 0x20
-                    );
+            template<typename Vec> struct pair_ref {
+                Vec& v0;
+                Vec& v1;
+            };
 
-                    decrypt_rounds(v0_vec, v1_vec);
+            template<typename Vec> static OBFUSCXX_FORCEINLINE void decrypt_rounds(Vec& v0_vec, Vec& v1_vec) {
+                pair_ref<Vec> pair{v0_vec, v1_vec};
+                run<false>(pair);
+            }
 
-                    __m128i v0_128lo = _mm256_castsi256_si128(v0_vec);
-                    __m128i v1_128lo = _mm256_castsi256_si128(v1_vec);
-                    __m128i v0_128hi = _mm256_extracti128_si256(v0_vec, 1);
-                    __m128i v1_128hi = _mm256_extracti128_si256(v1_vec, 1);
+            template<typename... Pairs> static OBFUSCXX_FORCEINLINE void decrypt_rounds_interleaved(Pairs&... pairs) {
+                run<false>(pairs...);
+            }
 
-                    alignas(32) std::uint64_t out64[8];
-                    _mm_store_si128(reinterpret_cast<__m128i*>(&out64[0]), _mm_unpacklo_epi32(v0_128lo, v1_128lo));
-                    _mm_store_si128(reinterpret_cast<__m128i*>(&out64[2]), _mm_unpackhi_epi32(v0_128lo, v1_128lo));
-                    _mm_store_si128(reinterpret_cast<__m128i*>(&out64[4]), _mm_unpacklo_epi32(v0_128hi, v1_128hi));
-                    _mm_store_si128(reinterpret_cast<__m128i*>(&out64[6]), _mm_unpackhi_epi32(v0_128hi, v1_128hi));
+            template<typename Vec> static OBFUSCXX_FORCEINLINE void encrypt_rounds(Vec& v0_vec, Vec& v1_vec) {
+                pair_ref<Vec> pair{v0_vec, v1_vec};
+                run<true>(pair);
+            }
 
-                    for (std::size_t j{}; j < 8 && (i + j) < count; ++j) {
-                        dst[i + j] = from_uint64(out64[j]);
-                    }
-                }
-#if defined(_MSC_VER) && !defined(__clang__) && !defined(OBFUSCXX_MSVC_FORCE_AVX2)
-            } else {
-                for (std::size_t i{}; i < aligned_count; i += 4) {
-                    const auto* p = reinterpret_cast<const __m128i*>(const_cast<const std::uint64_t*>(src + i));
-
-                    __m128i d0 = _mm_load_si128(p);
-                    __m128i d1 = _mm_load_si128(p + 1);
-                    __m128i mask = _mm_set1_epi64x(0xFFFFFFFF);
-                    __m128i v0_vec = _mm_castps_si128(_mm_shuffle_ps(
-                        _mm_castsi128_ps(_mm_and_si128(d0, mask)),
-                        _mm_castsi128_ps(_mm_and_si128(d1, mask)),
-                        _MM_SHUFFLE(2, 0, 2, 0)
-                    ));
-                    __m128i v1_vec = _mm_castps_si128(_mm_shuffle_ps(
-                        _mm_castsi128_ps(_mm_srli_epi64(d0, 32)),
-                        _mm_castsi128_ps(_mm_srli_epi64(d1, 32)),
-                        _MM_SHUFFLE(2, 0, 2, 0)
-                    ));
-
-                    decrypt_rounds(v0_vec, v1_vec);
-
-                    __m128i lo64 = _mm_unpacklo_epi32(v0_vec, v1_vec);
-                    __m128i hi64 = _mm_unpackhi_epi32(v0_vec, v1_vec);
-                    alignas(16) std::uint64_t out64[4];
-                    _mm_store_si128(reinterpret_cast<__m128i*>(&out64[0]), lo64);
-                    _mm_store_si128(reinterpret_cast<__m128i*>(&out64[2]), hi64);
-
-                    for (std::size_t j{}; j < 4 && (i + j) < count; ++j) {
-                        dst[i + j] = from_uint64(out64[j]);
-                    }
-                }
+            template<typename... Pairs> static OBFUSCXX_FORCEINLINE void encrypt_rounds_interleaved(Pairs&... pairs) {
+                run<true>(pairs...);
             }
-#endif
-#else
-            for (std::size_t i{}; i < aligned_count; i += 4) {
-                const auto* p = reinterpret_cast<const __m128i*>(const_cast<const std::uint64_t*>(src + i));
+        };
+    };
 
-                __m128i const d0 = _mm_load_si128(p);
-                __m128i const d1 = _mm_load_si128(p + 1);
-                __m128i const mask = _mm_set1_epi64x(0xFFFFFFFF);
-                __m128i v0_vec = _mm_castps_si128(_mm_shuffle_ps(
-                    _mm_castsi128_ps(_mm_and_si128(d0, mask)),
-                    _mm_castsi128_ps(_mm_and_si128(d1, mask)),
-                    _MM_SHUFFLE(2, 0, 2, 0)
-                ));
-                __m128i v1_vec = _mm_castps_si128(_mm_shuffle_ps(
-                    _mm_castsi128_ps(_mm_srli_epi64(d0, 32)),
-                    _mm_castsi128_ps(_mm_srli_epi64(d1, 32)),
-                    _MM_SHUFFLE(2, 0, 2, 0)
-                ));
+    // SPECK 64/128: one add, two rotates and two xors per round, all of which map onto single SIMD instructions (the
+    // 8-bit rotate is a byte shuffle on AVX2 and a native rotate on AVX-512). A round has roughly half the latency of
+    // an XTEA cycle and diffuses faster, so equal-level reads are cheaper; High runs the full 27-round cipher.
+    struct speck {
+        template<obf_level Level, std::uint64_t Entropy> struct engine {
+            static constexpr detail::speck_key key = detail::make_speck_key(Entropy, Level);
+            static constexpr std::uint32_t rounds = key.rounds;
+            static constexpr bool counter_mode = false;
+
+            static constexpr std::uint64_t encrypt(std::uint64_t block) {
+                return detail::speck_encrypt(key, block);
+            }
 
-                decrypt_rounds(v0_vec, v1_vec);
+            // v0 holds the low (y) words and v1 the high (x) words of the blocks.
+            template<typename Vec>
+            static OBFUSCXX_FORCEINLINE void decrypt_round(Vec& v0_vec, Vec& v1_vec, std::uint32_t round) {
+                using S = simd<Vec>;
+                v0_vec = S::template rotr<3>(S::vxor(v0_vec, v1_vec));
+                v1_vec = S::vxor(v1_vec, S::broadcast(key.k[round]));
+                v1_vec = S::template rotl<8>(S::vsub(v1_vec, v0_vec));
+            }
 
-                __m128i const lo64 = _mm_unpacklo_epi32(v0_vec, v1_vec);
-                __m128i const hi64 = _mm_unpackhi_epi32(v0_vec, v1_vec);
-                alignas(16) std::uint64_t out64[4];
-                _mm_store_si128(reinterpret_cast<__m128i*>(&out64[0]), lo64);
-                _mm_store_si128(reinterpret_cast<__m128i*>(&out64[2]), hi64);
+            template<typename Vec> static OBFUSCXX_FORCEINLINE void decrypt_rounds(Vec& v0_vec, Vec& v1_vec) {
+                for (std::uint32_t round = rounds; round-- != 0;) {
+                    OBFUSCXX_MEM_BARRIER_VEC(v0_vec, v1_vec, round)
+                    decrypt_round(v0_vec, v1_vec, round);
+                }
+            }
 
-                for (std::size_t j{}; j < 4 && (i + j) < count; ++j) {
-                    dst[i + j] = from_uint64(out64[j]);
+            template<typename... Pairs> static OBFUSCXX_FORCEINLINE void decrypt_rounds_interleaved(Pairs&... pairs) {
+                for (std::uint32_t round = rounds; round-- != 0;) {
+                    (decrypt_pair_round(pairs, round), ...);
                 }
             }
-#endif
-        }
 
-        static constexpr std::uint64_t to_uint64(Type value) {
-            if constexpr (std::is_pointer_v<Type>) {
-                return reinterpret_cast<std::uint64_t>(value);
-            } else if constexpr (std::is_floating_point_v<Type>) {
-                if constexpr (sizeof(Type) == 4) {
-                    return __builtin_bit_cast(std::uint32_t, value);
-                } else {
-                    return __builtin_bit_cast(std::uint64_t, value);
+            template<typename Pair>
+            static OBFUSCXX_FORCEINLINE void decrypt_pair_round(Pair& pair, std::uint32_t round) {
+                OBFUSCXX_MEM_BARRIER_VEC(pair.v0, pair.v1, round)
+                decrypt_round(pair.v0, pair.v1, round);
+            }
+
+            template<typename Vec>
+            static OBFUSCXX_FORCEINLINE void encrypt_round(Vec& v0_vec, Vec& v1_vec, std::uint32_t round) {
+                using S = simd<Vec>;
+                v1_vec = S::vxor(S::vadd(S::template rotr<8>(v1_vec), v0_vec), S::broadcast(key.k[round]));
+                v0_vec = S::vxor(S::template rotl<3>(v0_vec), v1_vec);
+            }
+
+            template<typename Vec> static OBFUSCXX_FORCEINLINE void encrypt_rounds(Vec& v0_vec, Vec& v1_vec) {
+                for (std::uint32_t round{}; round < rounds; ++round) {
+                    OBFUSCXX_MEM_BARRIER_VEC(v0_vec, v1_vec, round)
+                    encrypt_round(v0_vec, v1_vec, round);
                 }
-            } else {
-                return static_cast<std::uint64_t>(value);
             }
-        }
 
-        static OBFUSCXX_FORCEINLINE Type from_uint64(std::uint64_t value) {
-            if constexpr (std::is_pointer_v<Type>) {
-                return reinterpret_cast<Type>(value);
-            } else if constexpr (std::is_floating_point_v<Type>) {
-                if constexpr (sizeof(Type) == 4) {
-                    return __builtin_bit_cast(Type, static_cast<std::uint32_t>(value));
-                } else {
-                    return __builtin_bit_cast(Type, value);
+            template<typename... Pairs> static OBFUSCXX_FORCEINLINE void encrypt_rounds_interleaved(Pairs&... pairs) {
+                for (std::uint32_t round{}; round < rounds; ++round) {
+                    (encrypt_pair_round(pairs, round), ...);
                 }
-            } else {
-                return static_cast<Type>(value);
             }
-        }
 
-        static OBFUSCXX_FORCEINLINE bool cpu_has_avx2() {
-#if !defined(__aarch64__) && !defined(_M_ARM64)
-            static const bool cached = []() {
-#if defined(_MSC_VER)
-                int cpu_info[4]{};
-                __cpuidex(cpu_info, 7, 0);
-                return (cpu_info[1] & (1 << 5)) != 0;
-#else
-                unsigned int eax, ebx, ecx, edx;
-                if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
-                    return false;
-                return (ebx & (1 << 5)) != 0;
-#endif
-            }();
-            return cached;
-#else
-            return false;
-#endif
-        }
+            template<typename Pair>
+            static OBFUSCXX_FORCEINLINE void encrypt_pair_round(Pair& pair, std::uint32_t round) {
+                OBFUSCXX_MEM_BARRIER_VEC(pair.v0, pair.v1, round)
+                encrypt_round(pair.v0, pair.v1, round);
+            }
+        };
+    };
 
-    public:
-        explicit consteval obfuscxx(passkey) {
-            for (std::size_t i{}; i < Size; ++i) {
-                storage_[i] = seed ^ iv[i & iv_size];
+    // Counter mode over another policy. Block i is stored as plaintext ^ Base(nonce ^ i), so reading runs the forward
+    // cipher over counters that are generated in registers instead of over loaded ciphertext: the rounds no longer
+    // wait on memory or on the block deinterleave, and the data only meets the keystream in a final xor. Element
+    // access stays O(1) by index. Counters cover 2^32 blocks.
+    template<class Base = xtea> struct ctr {
+        template<obf_level Level, std::uint64_t Entropy> struct engine {
+            using base = typename Base::template engine<Level, Entropy>;
+            static_assert(!base::counter_mode, "ctr<> cannot be nested");
+
+            static constexpr std::uint32_t rounds = base::rounds;
+            static constexpr bool counter_mode = true;
+            static constexpr std::uint64_t nonce = detail::splitmix64(Entropy ^ 0x2545f4914f6cdd1dULL);
+
+            static constexpr std::uint64_t counter(std::size_t index) {
+                return nonce ^ static_cast<std::uint32_t>(index);
             }
-        }
 
-        explicit consteval obfuscxx(Type val) : obfuscxx(passkey{}) {
-            storage_[0] = encrypt(val);
-        }
+            static constexpr std::uint64_t keystream(std::size_t index) {
+                return base::encrypt(counter(index));
+            }
 
-        explicit consteval obfuscxx(Type (&arr)[Size]) : obfuscxx(passkey{}) {
-            for (std::size_t i{}; i < Size; ++i) {
-                storage_[i] = encrypt(arr[i]);
+            // Reading and writing both run the forward cipher; the kernels apply these to counter vectors.
+            template<typename Vec> static OBFUSCXX_FORCEINLINE void decrypt_rounds(Vec& v0_vec, Vec& v1_vec) {
+                base::encrypt_rounds(v0_vec, v1_vec);
             }
-        }
 
-        explicit consteval obfuscxx(const Type (&arr)[Size]) : obfuscxx(passkey{}) {
-            for (std::size_t i{}; i < Size; ++i) {
-                storage_[i] = encrypt(arr[i]);
+            template<typename... Pairs> static OBFUSCXX_FORCEINLINE void decrypt_rounds_interleaved(Pairs&... pairs) {
+                base::encrypt_rounds_interleaved(pairs...);
             }
-        }
 
-        consteval obfuscxx(const std::initializer_list<Type>& list) : obfuscxx(passkey{}) {
-            for (std::size_t i{}; const auto& v : list) {
-                storage_[i++] = encrypt(v);
+            template<typename Vec> static OBFUSCXX_FORCEINLINE void encrypt_rounds(Vec& v0_vec, Vec& v1_vec) {
+                base::encrypt_rounds(v0_vec, v1_vec);
             }
-        }
+        };
+    };
 
-        OBFUSCXX_FORCEINLINE Type get() const
-            requires is_single
-        {
-            volatile const std::uint64_t* ptr = &storage_[0];
-            std::uint64_t val = *ptr;
-            return decrypt(val);
-        }
+    namespace detail {
+        // Round parameters of an XTEA instance as plain data, the only input of the outlined kernels.
+        struct xtea_schedule {
+            std::uint32_t rounds;
+            std::uint32_t delta;
+            std::uint32_t keys[4];
+        };
 
-        OBFUSCXX_FORCEINLINE Type get(std::size_t i) const
-            requires is_array
-        {
-            volatile const std::uint64_t* ptr = &storage_[i];
-            std::uint64_t val = *ptr;
-            return decrypt(val);
+        template<typename Vec>
+        OBFUSCXX_FORCEINLINE void xtea_decrypt_schedule(Vec& v0, Vec& v1, const xtea_schedule& schedule) {
+            std::uint32_t sum = schedule.delta * schedule.rounds;
+            for (std::uint32_t i{}; i < schedule.rounds; ++i) {
+                OBFUSCXX_MEM_BARRIER_VEC(v0, v1, sum)
+                xtea::half_round(v0, v1, sum + schedule.keys[(sum >> 11) & 3]);
+                sum -= schedule.delta;
+                OBFUSCXX_MEM_BARRIER_VEC(v0, v1, sum)
+                xtea::half_round(v1, v0, sum + schedule.keys[sum & 3]);
+            }
         }
 
-        OBFUSCXX_FORCEINLINE void copy_to(Type* out, std::size_t count) const
-            requires is_array
-        {
-            std::size_t effective_count = (count < Size) ? count : Size;
-            decrypt_vectorized(storage_, out, effective_count);
+        // Two vectors per iteration where possible, so the serial round chains of both overlap.
+        template<typename Vec>
+        OBFUSCXX_FORCEINLINE void xtea_decrypt_lanes(
+            const std::uint64_t* src, std::uint64_t* dst, std::size_t blocks, const xtea_schedule& schedule
+        ) {
+            using S = simd<Vec>;
+            std::size_t i{};
+            for (; i + (2 * S::lanes) <= blocks; i += 2 * S::lanes) {
+                Vec a0;
+                Vec a1;
+                Vec b0;
+                Vec b1;
+                S::load_blocks(src + i, a0, a1);
+                S::load_blocks(src + i + S::lanes, b0, b1);
+                std::uint32_t sum = schedule.delta * schedule.rounds;
+                for (std::uint32_t r{}; r < schedule.rounds; ++r) {
+                    std::uint32_t key = sum + schedule.keys[(sum >> 11) & 3];
+                    OBFUSCXX_MEM_BARRIER_VEC(a0, a1, sum)
+                    xtea::half_round(a0, a1, key);
+                    OBFUSCXX_MEM_BARRIER_VEC(b0, b1, sum)
+                    xtea::half_round(b0, b1, key);
+                    sum -= schedule.delta;
+                    key = sum + schedule.keys[sum & 3];
+                    OBFUSCXX_MEM_BARRIER_VEC(a0, a1, sum)
+                    xtea::half_round(a1, a0, key);
+                    OBFUSCXX_MEM_BARRIER_VEC(b0, b1, sum)
+                    xtea::half_round(b1, b0, key);
+                }
+                S::store_blocks(dst + i, a0, a1);
+                S::store_blocks(dst + i + S::lanes, b0, b1);
+            }
+            for (; i < blocks; i += S::lanes) {
+                Vec v0;
+                Vec v1;
+                S::load_blocks(src + i, v0, v1);
+                xtea_decrypt_schedule(v0, v1, schedule);
+                S::store_blocks(dst + i, v0, v1);
+            }
         }
 
-        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE void set(Type val)
-            requires is_single
-        {
-            storage_[0] = encrypt(val);
+        template<typename Vec>
+        OBFUSCXX_FORCEINLINE std::uint64_t xtea_decrypt_block(std::uint64_t block, const xtea_schedule& schedule) {
+            using S = simd<Vec>;
+            auto v0 = S::from_scalar(static_cast<std::uint32_t>(block));
+            auto v1 = S::from_scalar(static_cast<std::uint32_t>(block >> 32));
+            xtea_decrypt_schedule(v0, v1, schedule);
+            return (static_cast<std::uint64_t>(S::to_scalar(v1)) << 32) | S::to_scalar(v0);
         }
 
-        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE void set(Type val, std::size_t i)
-            requires is_array
-        {
-            storage_[i] = encrypt(val);
-        }
+        // The shared out-of-line kernels of the outlined policy, keyed by vector width in bits: one per width for the
+        // whole program, whatever the number of instances. blocks is a multiple of the vector's lane count and both
+        // buffers are aligned to the vector size.
+        template<std::size_t Bits> struct outlined_kernels;
 
-        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE void set(const std::initializer_list<Type>& list)
+        template<> struct outlined_kernels<128> {
+            static OBFUSCXX_NOINLINE void decrypt(
+                const std::uint64_t* src, std::uint64_t* dst, std::size_t blocks, const xtea_schedule& schedule
+            ) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+                xtea_decrypt_lanes<uint32x4_t>(src, dst, blocks, schedule);
+#else
+                xtea_decrypt_lanes<__m128i>(src, dst, blocks, schedule);
+#endif
+            }
+
+            static OBFUSCXX_NOINLINE std::uint64_t decrypt_block(std::uint64_t block, const xtea_schedule& schedule) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+                return xtea_decrypt_block<uint32x4_t>(block, schedule);
+#else
+                return xtea_decrypt_block<__m128i>(block, schedule);
+#endif
+            }
+        };
+
+#if !defined(__aarch64__) && !defined(_M_ARM64)
+#if OBFUSCXX_HAS_AVX2 || OBFUSCXX_HAS_DISPATCH
+        template<> struct outlined_kernels<256> {
+            static OBFUSCXX_OUTLINED_AVX2 void decrypt(
+                const std::uint64_t* src, std::uint64_t* dst, std::size_t blocks, const xtea_schedule& schedule
+            ) {
+                xtea_decrypt_lanes<__m256i>(src, dst, blocks, schedule);
+            }
+        };
+#endif
+#if OBFUSCXX_HAS_AVX512 || OBFUSCXX_HAS_DISPATCH
+        template<> struct outlined_kernels<512> {
+            static OBFUSCXX_OUTLINED_AVX512 void decrypt(
+                const std::uint64_t* src, std::uint64_t* dst, std::size_t blocks, const xtea_schedule& schedule
+            ) {
+                xtea_decrypt_lanes<__m512i>(src, dst, blocks, schedule);
+            }
+        };
+#endif
+#endif
+    } // namespace detail
+
+    // XTEA with decryption routed through detail::outlined_kernels instead of being expanded at every call site. The
+    // ciphertext is identical to xtea's; only the rounds, delta and key words differ between instances, and they are
+    // passed to the shared kernels as data. Encryption at runtime stays inline.
+    struct outlined {
+        template<obf_level Level, std::uint64_t Entropy> struct engine : xtea::engine<Level, Entropy> {
+            using base = xtea::engine<Level, Entropy>;
+            static constexpr bool out_of_line = true;
+            static constexpr detail::xtea_schedule schedule{
+                base::rounds,
+                base::delta,
+                {static_cast<std::uint32_t>(base::key.iv[0]),
+                 static_cast<std::uint32_t>(base::key.iv[1]),
+                 static_cast<std::uint32_t>(base::key.iv[2]),
+                 static_cast<std::uint32_t>(base::key.iv[3])},
+            };
+        };
+    };
+
+    // Cipher used when none is given. OBFUSCXX_OUTLINE switches every such instance to the outlined kernels.
+#if defined(OBFUSCXX_OUTLINE)
+    using default_cipher = outlined;
+#else
+    using default_cipher = xtea;
+#endif
+
+    namespace detail {
+        // Identity of an obfuscxx instantiation, hashed from its spelled-out type. It keys profile records and level
+        // overrides, and is only stable between builds when OBFUSCXX_ENTROPY_SEED pins the entropy.
+        template<class T> consteval std::uint64_t site_id() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return splitmix64(hash_compile_time(__FUNCSIG__));
+#else
+            return splitmix64(hash_compile_time(__PRETTY_FUNCTION__));
+#endif
+        }
+
+        struct level_override {
+            std::uint64_t site;
+            obf_level level;
+        };
+
+        // Entries come from the header named by OBFUSCXX_LEVEL_OVERRIDES, normally generated from a profile by the
+        // obfuscxx_level_overrides() CMake function; each line of it is OBFUSCXX_LEVEL_OVERRIDE(<site id>, <level>).
+        // The trailing entry only keeps the array non-empty.
+        inline constexpr level_override level_overrides[] = {
+#if defined(OBFUSCXX_LEVEL_OVERRIDES)
+#define OBFUSCXX_LEVEL_OVERRIDE(site, level) {site, obf_level::level},
+#include OBFUSCXX_LEVEL_OVERRIDES
+#undef OBFUSCXX_LEVEL_OVERRIDE
+#endif
+            {0, obf_level::Low},
+        };
+
+        template<std::size_t N>
+        consteval obf_level resolve_level(std::uint64_t site, obf_level level, const level_override (&table)[N]) {
+            for (const level_override& entry : table) {
+                if (entry.site == site && site != 0) {
+                    return entry.level;
+                }
+            }
+            return level;
+        }
+
+        constexpr const char* level_name(obf_level level) {
+            switch (level) {
+            case obf_level::Low:
+                return "Low";
+            case obf_level::Medium:
+                return "Medium";
+            case obf_level::High:
+                return "High";
+            }
+            return "Low";
+        }
+
+#if defined(OBFUSCXX_PROFILE)
+#ifndef OBFUSCXX_PROFILE_CAPACITY
+#define OBFUSCXX_PROFILE_CAPACITY 8192
+#endif
+        using site_location = std::source_location;
+
+        struct profile_record {
+            std::atomic<std::uint64_t> key;
+            std::atomic<std::uint64_t> calls;
+            std::uint64_t site;
+            const char* file;
+            std::uint32_t line;
+            obf_level level;
+            std::size_t size;
+        };
+
+        // Read counts per instantiation and construction site. A fixed open-addressing table, so recording a call
+        // never allocates or locks; calls from sites beyond the capacity are dropped. The table is written out when
+        // the program exits, to $OBFUSCXX_PROFILE_FILE or obfuscxx.profile.
+        struct profile_table {
+            static constexpr std::size_t capacity = OBFUSCXX_PROFILE_CAPACITY;
+            static_assert((capacity & (capacity - 1)) == 0, "OBFUSCXX_PROFILE_CAPACITY must be a power of two");
+
+            profile_record records[capacity]{};
+
+            ~profile_table() {
+                const char* path = std::getenv("OBFUSCXX_PROFILE_FILE");
+                if (std::FILE* out = std::fopen(path != nullptr ? path : "obfuscxx.profile", "w")) {
+                    write(out);
+                    std::fclose(out);
+                }
+            }
+
+            void hit(std::uint64_t site, const char* file, std::uint32_t line, obf_level level, std::size_t size) {
+                std::uint64_t const key =
+                    splitmix64(site ^ rol64(reinterpret_cast<std::uintptr_t>(file), 17) ^ line) | 1;
+                for (std::size_t probe{}; probe < capacity; ++probe) {
+                    profile_record& record = records[(key + probe) & (capacity - 1)];
+                    std::uint64_t current = record.key.load(std::memory_order_acquire);
+                    if (current == 0 && record.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                        record.site = site;
+                        record.file = file;
+                        record.line = line;
+                        record.level = level;
+                        record.size = size;
+                        current = key;
+                    }
+                    if (current == key) {
+                        record.calls.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            }
+
+            // One record per line: site id, calls, declared level, size, line, file.
+            void write(std::FILE* out) const {
+                std::fprintf(out, "# obfuscxx profile: site calls level size line file\n");
+                for (const profile_record& record : records) {
+                    if (record.key.load(std::memory_order_acquire) == 0) {
+                        continue;
+                    }
+                    std::fprintf(
+                        out,
+                        "0x%016llx %llu %s %zu %u %s\n",
+                        static_cast<unsigned long long>(record.site),
+                        static_cast<unsigned long long>(record.calls.load(std::memory_order_relaxed)),
+                        level_name(record.level),
+                        record.size,
+                        static_cast<unsigned>(record.line),
+                        record.file
+                    );
+                }
+            }
+        };
+
+        inline profile_table profile_data;
+#else
+        // Stand-in for std::source_location when profiling is off, so the constructors keep one signature.
+        struct site_location {
+            static consteval site_location current() {
+                return {};
+            }
+        };
+#endif
+
+        enum class trace_event : std::uint8_t { scalar_decrypt, vector_decrypt, runtime_encrypt };
+
+#if defined(OBFUSCXX_TRACE)
+#ifndef OBFUSCXX_TRACE_FLUSH
+#define OBFUSCXX_TRACE_FLUSH 1024
+#endif
+        template<class T> consteval const char* type_name() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return __FUNCSIG__;
+#else
+            return __PRETTY_FUNCTION__;
+#endif
+        }
+
+        // Totals of one instantiation, linked into a global list the first time any thread publishes counts for it.
+        struct trace_site {
+            constexpr explicit trace_site(const char* type) : name(type) {}
+
+            const char* name;
+            std::atomic<std::uint64_t> counts[3]{};
+            std::atomic<bool> linked{};
+            trace_site* next{};
+        };
+
+        inline std::atomic<trace_site*> trace_sites{};
+
+        struct trace_local;
+        inline thread_local trace_local* trace_thread_locals{};
+
+        // Per-thread counts of one instantiation. Recording an event only touches thread-local memory; the counts are
+        // added to the shared totals every OBFUSCXX_TRACE_FLUSH events, on flush_trace() and when the thread exits.
+        struct trace_local {
+            constexpr explicit trace_local(trace_site* owner) : site(owner) {}
+
+            trace_local(const trace_local&) = delete;
+            trace_local& operator=(const trace_local&) = delete;
+
+            ~trace_local() {
+                flush();
+            }
+
+            OBFUSCXX_FORCEINLINE void add(trace_event event, std::uint64_t n) {
+                if (!linked) {
+                    linked = true;
+                    next = trace_thread_locals;
+                    trace_thread_locals = this;
+                }
+                counts[static_cast<std::size_t>(event)] += n;
+                if (++pending >= OBFUSCXX_TRACE_FLUSH) {
+                    flush();
+                }
+            }
+
+            void flush() {
+                for (std::size_t i{}; i < 3; ++i) {
+                    if (counts[i] != 0) {
+                        site->counts[i].fetch_add(counts[i], std::memory_order_relaxed);
+                        counts[i] = 0;
+                    }
+                }
+                pending = 0;
+                if (!site->linked.exchange(true, std::memory_order_acq_rel)) {
+                    site->next = trace_sites.load(std::memory_order_relaxed);
+                    while (!trace_sites.compare_exchange_weak(site->next, site, std::memory_order_release)) {
+                    }
+                }
+            }
+
+            trace_site* site;
+            std::uint64_t counts[3]{};
+            std::uint32_t pending{};
+            bool linked{};
+            trace_local* next{};
+        };
+
+        // Strips the type_name() wrapper down to the obfuscxx type.
+        inline void write_type_name(std::FILE* out, const char* name) {
+            const char* begin = name;
+            for (const char* p = name; *p != 0; ++p) {
+                if (p[0] == 'T' && p[1] == ' ' && p[2] == '=' && p[3] == ' ') {
+                    begin = p + 4;
+                    break;
+                }
+            }
+            const char* end = begin;
+            while (*end != 0 && *end != ';' && !(end[0] == ']' && end[1] == 0)) {
+                ++end;
+            }
+            std::fprintf(out, "%.*s", static_cast<int>(end - begin), begin);
+        }
+#endif
+    } // namespace detail
+
+#if defined(OBFUSCXX_PROFILE)
+    // Writes the counts gathered so far in the format obfuscxx_levels reads; the same happens automatically at exit.
+    inline void write_profile(std::FILE* out) {
+        detail::profile_data.write(out);
+    }
+#endif
+
+#if defined(OBFUSCXX_TRACE)
+    // Totals of one instantiation: blocks decrypted one at a time (get(), operator[], read-modify-write), blocks
+    // decrypted by the vector kernels (copy_to() and everything built on it, decrypt_all()), and blocks encrypted at
+    // run time (set(), assign(), map lookups).
+    struct trace_stats {
+        const char* name;
+        std::uint64_t scalar_decrypts;
+        std::uint64_t vector_decrypts;
+        std::uint64_t runtime_encrypts;
+    };
+
+    // Publishes the counts the calling thread has not flushed yet. Other threads publish theirs periodically.
+    inline void flush_trace() {
+        for (detail::trace_local* local = detail::trace_thread_locals; local != nullptr; local = local->next) {
+            local->flush();
+        }
+    }
+
+    // Calls fn(const trace_stats&) for every instantiation that has published counts.
+    template<class Fn> void for_each_trace(Fn&& fn) {
+        for (detail::trace_site* site = detail::trace_sites.load(std::memory_order_acquire); site != nullptr;
+             site = site->next) {
+            fn(trace_stats{
+                site->name,
+                site->counts[0].load(std::memory_order_relaxed),
+                site->counts[1].load(std::memory_order_relaxed),
+                site->counts[2].load(std::memory_order_relaxed)
+            });
+        }
+    }
+
+    // Totals of one instantiation, e.g. trace_of<decltype(table)>(); zero if it has published nothing yet.
+    template<class Obfuscxx> trace_stats trace_of() {
+        trace_stats result{detail::type_name<Obfuscxx>(), 0, 0, 0};
+        for_each_trace([&result](const trace_stats& stats) {
+            if (std::strcmp(stats.name, result.name) == 0) {
+                result = stats;
+            }
+        });
+        return result;
+    }
+
+    inline void write_trace(std::FILE* out) {
+        std::fprintf(out, "# obfuscxx trace: scalar_decrypts vector_decrypts runtime_encrypts type\n");
+        for_each_trace([out](const trace_stats& stats) {
+            std::fprintf(
+                out,
+                "%llu %llu %llu ",
+                static_cast<unsigned long long>(stats.scalar_decrypts),
+                static_cast<unsigned long long>(stats.vector_decrypts),
+                static_cast<unsigned long long>(stats.runtime_encrypts)
+            );
+            detail::write_type_name(out, stats.name);
+            std::fputc('\n', out);
+        });
+    }
+
+    namespace detail {
+        // Written to $OBFUSCXX_TRACE_FILE, or stderr, when the program exits. Thread-local counts of the main thread
+        // are destroyed, and so published, before this runs.
+        struct trace_report {
+            ~trace_report() {
+                if (trace_sites.load(std::memory_order_acquire) == nullptr) {
+                    return;
+                }
+                const char* path = std::getenv("OBFUSCXX_TRACE_FILE");
+                std::FILE* out = path != nullptr ? std::fopen(path, "w") : stderr;
+                if (out != nullptr) {
+                    ngu::write_trace(out);
+                    if (out != stderr) {
+                        std::fclose(out);
+                    }
+                }
+            }
+        };
+
+        inline trace_report trace_at_exit;
+    } // namespace detail
+#endif
+
+    template<class Key, class Value, std::size_t N, obf_level Level, std::uint64_t Entropy, std::size_t KeyBytes>
+    class obfuscxx_map;
+    template<class Type, std::size_t Size, obf_level Level, std::uint64_t Entropy> class obfuscxx_blob;
+    template<class Type, obf_level Level, std::uint64_t Entropy, class Cipher> class obfuscxx_atomic;
+    template<class Type, std::size_t Size, obf_level Level, std::uint64_t Entropy, class Cipher> class obfuscxx_seqlock;
+
+    namespace detail {
+        // Zeroes memory holding plaintext. The barrier makes the buffer look read afterwards, so the stores cannot be
+        // dropped as dead even when the buffer goes out of scope right after.
+        inline void secure_wipe(void* data, std::size_t size) {
+#if defined(__clang__) || defined(__GNUC__)
+            __builtin_memset(data, 0, size);
+            __asm__ volatile("" : : "r"(data) : "memory");
+#else
+            auto* bytes = static_cast<volatile unsigned char*>(data);
+            for (std::size_t i{}; i < size; ++i) {
+                bytes[i] = 0;
+            }
+#endif
+        }
+
+        // Storage blocks addressed by their index in the whole array, of which only the blocks from base on are held at
+        // data. The kernels take it in place of a storage pointer, so they can also run on a few groups copied out of
+        // a larger array; a plain storage pointer converts to a window starting at block 0.
+        template<class Block> struct block_window {
+            Block* data;
+            std::size_t base{};
+
+            constexpr block_window(Block* blocks, std::size_t first = 0) : data(blocks), base(first) {}
+            template<class Other>
+            constexpr block_window(const block_window<Other>& other) : data(other.data), base(other.base) {}
+
+            constexpr Block* operator+(std::size_t index) const {
+                return data + (index - base);
+            }
+            constexpr Block& operator[](std::size_t index) const {
+                return data[index - base];
+            }
+        };
+
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+#ifndef OBFUSCXX_ARENA_SIZE
+#define OBFUSCXX_ARENA_SIZE 4096
+#endif
+        // Per-thread bump allocator behind obfuscxx::to_string_view(). Requests that no longer fit the inline buffer
+        // get a heap chunk of their own. restore() wipes and releases everything handed out since the mark.
+        class plaintext_arena {
+            // The header is padded to 16 bytes so the data after it keeps the alignment of the inline buffer on
+            // ILP32 targets too.
+            struct alignas(16) overflow_chunk {
+                overflow_chunk* next;
+                std::size_t size;
+            };
+
+        public:
+            struct mark {
+                std::size_t used;
+                overflow_chunk* overflow;
+            };
+
+            plaintext_arena() = default;
+            plaintext_arena(const plaintext_arena&) = delete;
+            plaintext_arena& operator=(const plaintext_arena&) = delete;
+
+            ~plaintext_arena() {
+                restore({0, nullptr});
+            }
+
+            void* allocate(std::size_t size) {
+                size = (size + 15) & ~std::size_t{15};
+                if (size <= sizeof(buffer_) - used_) {
+                    void* data = buffer_ + used_;
+                    used_ += size;
+                    return data;
+                }
+                auto* chunk = static_cast<overflow_chunk*>(
+                    ::operator new(sizeof(overflow_chunk) + size, std::align_val_t{alignof(overflow_chunk)})
+                );
+                chunk->next = overflow_;
+                chunk->size = size;
+                overflow_ = chunk;
+                return chunk + 1;
+            }
+
+            mark save() const {
+                return {used_, overflow_};
+            }
+
+            void restore(mark to) {
+                secure_wipe(buffer_ + to.used, used_ - to.used);
+                used_ = to.used;
+                while (overflow_ != to.overflow) {
+                    overflow_chunk* next = overflow_->next;
+                    secure_wipe(overflow_ + 1, overflow_->size);
+                    ::operator delete(overflow_, std::align_val_t{alignof(overflow_chunk)});
+                    overflow_ = next;
+                }
+            }
+
+        private:
+            alignas(64) unsigned char buffer_[OBFUSCXX_ARENA_SIZE];
+            std::size_t used_{};
+            overflow_chunk* overflow_{};
+        };
+
+        inline thread_local plaintext_arena thread_arena;
+#endif
+    } // namespace detail
+
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+    // Marks a region of the calling thread's plaintext arena. Views returned by to_string_view() while the scope is
+    // open stay valid until it closes; the plaintext is then wiped and the space reused. Scopes nest.
+    class plaintext_scope {
+    public:
+        plaintext_scope() : arena_(&detail::thread_arena), mark_(arena_->save()) {}
+
+        plaintext_scope(const plaintext_scope&) = delete;
+        plaintext_scope& operator=(const plaintext_scope&) = delete;
+
+        ~plaintext_scope() {
+            arena_->restore(mark_);
+        }
+
+    private:
+        detail::plaintext_arena* arena_;
+        detail::plaintext_arena::mark mark_;
+    };
+#endif
+
+    // Decrypts an obfuscxx instance once and keeps the plaintext in a local buffer for the handle's lifetime, so hot
+    // loops pay the decrypt latency a single time. The buffer is wiped on destruction. Prefer obfuscxx::lock().
+    template<class Type, std::size_t Size> class scoped_plain {
+    public:
+        template<class Source> OBFUSCXX_FORCEINLINE explicit scoped_plain(const Source& source) {
+            if constexpr (Size == 1) {
+                data_[0] = source.get();
+            } else {
+                source.copy_to(data_, Size);
+            }
+        }
+
+        scoped_plain(const scoped_plain&) = delete;
+        scoped_plain& operator=(const scoped_plain&) = delete;
+
+        OBFUSCXX_FORCEINLINE ~scoped_plain() {
+            detail::secure_wipe(data_, sizeof(data_));
+        }
+
+        const Type& get() const
+            requires(Size == 1)
+        {
+            return data_[0];
+        }
+        const Type& operator*() const
+            requires(Size == 1)
+        {
+            return data_[0];
+        }
+
+        const Type& operator[](std::size_t i) const {
+            return data_[i];
+        }
+        const Type* data() const {
+            return data_;
+        }
+        const Type* begin() const {
+            return data_;
+        }
+        const Type* end() const {
+            return data_ + Size;
+        }
+        static constexpr std::size_t size() {
+            return Size;
+        }
+
+    private:
+        Type data_[Size];
+    };
+
+    template<
+        class Type,
+        std::size_t Size = 1,
+        obf_level Level = obf_level::Low,
+        std::uint64_t Entropy = OBFUSCXX_ENTROPY,
+        class Cipher = default_cipher>
+    class obfuscxx {
+        static constexpr bool is_single = Size == 1;
+        static constexpr bool is_array = Size > 1;
+        static constexpr bool is_single_pointer = std::is_pointer_v<Type> && Size == 1;
+        static constexpr bool is_char = std::is_same_v<Type, char> || std::is_same_v<Type, const char>;
+        static constexpr bool is_wchar = std::is_same_v<Type, wchar_t> || std::is_same_v<Type, const wchar_t>;
+
+        static_assert(std::is_trivially_copyable_v<Type>, "obfuscxx stores trivially copyable types only");
+
+        // Types wider than a block are stored as words_per_element consecutive blocks per element. The vector kernels
+        // then run over those 64-bit words instead of over elements, and whole elements are put back together with
+        // bit_cast once the words are decrypted.
+        static constexpr bool is_wide = sizeof(Type) > 8;
+        static constexpr std::size_t words_per_element = (sizeof(Type) + 7) / 8;
+        using unit_type = std::conditional_t<is_wide, std::uint64_t, Type>;
+
+        static constexpr bool is_packed =
+            is_array && sizeof(Type) < 8 && (std::is_integral_v<Type> || std::is_floating_point_v<Type>);
+
+        static constexpr std::size_t elements_per_block = is_packed ? 8 / sizeof(Type) : 1;
+        static constexpr std::size_t element_bits = 64 / elements_per_block;
+        static constexpr std::uint64_t element_mask = is_packed ? (1ULL << element_bits) - 1 : ~0ULL;
+        static constexpr std::size_t block_count =
+            ((Size * words_per_element) + elements_per_block - 1) / elements_per_block;
+
+        // Storage read by the dispatched kernels takes the AVX-512F layout. Single values never reach them, so they
+        // keep the layout of the compile-time instruction set.
+        static constexpr bool dispatch_layout = OBFUSCXX_HAS_DISPATCH && (is_array || is_wide);
+        static constexpr std::size_t storage_multiple =
+            (OBFUSCXX_HAS_AVX512 || dispatch_layout) ? 16 : OBFUSCXX_HAS_AVX2 ? 8 : 4;
+        static constexpr std::size_t storage_alignment =
+            (OBFUSCXX_HAS_AVX512 || dispatch_layout) ? 64 : OBFUSCXX_HAS_AVX2 ? 32 : 16;
+        static constexpr std::size_t storage_size =
+            (is_array || is_wide) ? (block_count + storage_multiple - 1) & ~(storage_multiple - 1) : Size;
+        static constexpr std::size_t group_elements = storage_multiple * elements_per_block;
+        // Whether equal values always have equal bits, so operator== and std::hash can work on the ciphertext.
+        static constexpr bool compares_bitwise =
+            std::has_unique_object_representations_v<Type> || std::is_pointer_v<Type> || std::is_enum_v<Type>;
+        // A multiple of every group_elements value, so full chunks always start on a group boundary.
+        static constexpr std::size_t default_chunk = 256;
+
+        struct passkey {
+            explicit passkey() = default;
+        };
+
+#if defined(OBFUSCXX_PROFILE) || defined(OBFUSCXX_LEVEL_OVERRIDES)
+        static constexpr std::uint64_t site_key = detail::site_id<obfuscxx>();
+#else
+        static constexpr std::uint64_t site_key = 0;
+#endif
+        static constexpr obf_level effective_level = detail::resolve_level(site_key, Level, detail::level_overrides);
+
+        static constexpr detail::xtea_key key_schedule = detail::make_xtea_key(Entropy, effective_level);
+        static constexpr std::uint64_t seed{key_schedule.seed};
+        static constexpr const std::uint64_t (&iv)[8] = key_schedule.iv;
+        static constexpr std::uint64_t iv_size = (sizeof(iv) / 8) - 1;
+
+        using engine = typename Cipher::template engine<effective_level, Entropy>;
+        static constexpr bool is_outlined = requires { requires engine::out_of_line; };
+        // Blocks decrypted per call of an outlined kernel; a multiple of every vector's lane count.
+        static constexpr std::size_t outline_batch = 64;
+
+#if defined(OBFUSCXX_TRACE)
+        static inline detail::trace_site trace_site_{detail::type_name<obfuscxx>()};
+        static inline thread_local detail::trace_local trace_local_{&trace_site_};
+#endif
+
+        static OBFUSCXX_FORCEINLINE void trace(detail::trace_event event, std::uint64_t n) {
+#if defined(OBFUSCXX_TRACE)
+            trace_local_.add(event, n);
+#else
+            static_cast<void>(event);
+            static_cast<void>(n);
+#endif
+        }
+
+        template<class... Objs> friend struct detail::batch_decryptor;
+        template<class Key, class Value, std::size_t N, obf_level L, std::uint64_t E, std::size_t K>
+        friend class obfuscxx_map;
+        template<class T, std::size_t S, obf_level L, std::uint64_t E> friend class obfuscxx_blob;
+        template<class T, obf_level L, std::uint64_t E, class C> friend class obfuscxx_atomic;
+        template<class T, std::size_t S, obf_level L, std::uint64_t E, class C> friend class obfuscxx_seqlock;
+
+        static constexpr std::uint64_t encrypt(Type value, std::size_t index = 0) {
+            return encrypt_block(to_uint64(value), index);
+        }
+
+        // index is the block's position in the storage; only counter-mode policies depend on it.
+        static constexpr std::uint64_t encrypt_block(std::uint64_t val, std::size_t index = 0) {
+            if (!std::is_constant_evaluated()) {
+                trace(detail::trace_event::runtime_encrypt, 1);
+            }
+            if constexpr (engine::counter_mode) {
+                return val ^ engine::keystream(index);
+            } else {
+                return engine::encrypt(val);
+            }
+        }
+
+        template<typename Vec>
+        static OBFUSCXX_FORCEINLINE std::uint64_t decrypt_scalar(std::uint32_t v0, std::uint32_t v1) {
+            using S = simd<Vec>;
+            auto sv0 = S::from_scalar(v0);
+            auto sv1 = S::from_scalar(v1);
+
+            engine::decrypt_rounds(sv0, sv1);
+
+            v0 = S::to_scalar(sv0);
+            v1 = S::to_scalar(sv1);
+            return (static_cast<std::uint64_t>(v1) << 32) | v0;
+        }
+
+        template<typename Vec> struct vec_pair {
+            Vec v0;
+            Vec v1;
+        };
+
+        static OBFUSCXX_FORCEINLINE Type decrypt(std::uint64_t value) {
+            return from_uint64(decrypt_block(value));
+        }
+
+        static OBFUSCXX_FORCEINLINE std::uint64_t decrypt_block(std::uint64_t value, std::size_t index = 0) {
+            trace(detail::trace_event::scalar_decrypt, 1);
+            if constexpr (engine::counter_mode) {
+                return value ^ transform_block(engine::counter(index));
+            } else {
+                return transform_block(value);
+            }
+        }
+
+        // Runs engine::decrypt_rounds() over one block in the widest vector type available.
+        static OBFUSCXX_FORCEINLINE std::uint64_t transform_block(std::uint64_t value) {
+            OBFUSCXX_MEM_BARRIER(value)
+
+            if constexpr (is_outlined) {
+                return detail::outlined_kernels<128>::decrypt_block(value, engine::schedule);
+            } else {
+                auto const v0 = static_cast<std::uint32_t>(value);
+                auto const v1 = static_cast<std::uint32_t>(value >> 32);
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+                return decrypt_scalar<uint32x4_t>(v0, v1);
+#elif OBFUSCXX_HAS_AVX2
+#if defined(_MSC_VER) && !defined(__clang__) && !defined(OBFUSCXX_MSVC_FORCE_AVX2)
+                if (active_kernel() == simd_kernel::Avx2) {
+                    return decrypt_scalar<__m256i>(v0, v1);
+                }
+                return decrypt_scalar<__m128i>(v0, v1);
+#else
+                return decrypt_scalar<__m256i>(v0, v1);
+#endif
+#else
+                return decrypt_scalar<__m128i>(v0, v1);
+#endif
+            }
+        }
+
+        // Decrypts elements [first, first + count) of the storage at src into dst[0, count).
+        static OBFUSCXX_FORCEINLINE void decrypt_vectorized(
+            detail::block_window<const volatile std::uint64_t> src, unit_type* dst, std::size_t first, std::size_t count
+        ) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+            decrypt_blocks<uint32x4_t>(src, dst, first, count);
+#elif OBFUSCXX_HAS_AVX512
+            decrypt_blocks<__m512i>(src, dst, first, count);
+#elif OBFUSCXX_HAS_DISPATCH
+            switch (active_kernel()) {
+            case simd_kernel::Avx512:
+                decrypt_blocks_avx512(src, dst, first, count);
+                break;
+            case simd_kernel::Avx2:
+                decrypt_blocks_avx2(src, dst, first, count);
+                break;
+            default:
+                decrypt_blocks<__m128i>(src, dst, first, count);
+                break;
+            }
+#elif OBFUSCXX_HAS_AVX2
+#if defined(_MSC_VER) && !defined(__clang__) && !defined(OBFUSCXX_MSVC_FORCE_AVX2)
+            if (active_kernel() == simd_kernel::Avx2) {
+                decrypt_blocks<__m256i>(src, dst, first, count);
+            } else {
+                decrypt_blocks<__m128i>(src, dst, first, count);
+            }
+#else
+            decrypt_blocks<__m256i>(src, dst, first, count);
+#endif
+#else
+            decrypt_blocks<__m128i>(src, dst, first, count);
+#endif
+        }
+
+        static OBFUSCXX_FORCEINLINE std::size_t encrypt_vectorized(
+            detail::block_window<volatile std::uint64_t> dst,
+            const unit_type* src,
+            std::size_t first,
+            std::size_t blocks
+        ) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+            return encrypt_blocks<uint32x4_t>(dst, src, first, blocks);
+#elif OBFUSCXX_HAS_AVX512
+            return encrypt_blocks<__m512i>(dst, src, first, blocks);
+#elif OBFUSCXX_HAS_DISPATCH
+            switch (active_kernel()) {
+            case simd_kernel::Avx512:
+                return encrypt_blocks_avx512(dst, src, first, blocks);
+            case simd_kernel::Avx2:
+                return encrypt_blocks_avx2(dst, src, first, blocks);
+            default:
+                return encrypt_blocks<__m128i>(dst, src, first, blocks);
+            }
+#elif OBFUSCXX_HAS_AVX2
+#if defined(_MSC_VER) && !defined(__clang__) && !defined(OBFUSCXX_MSVC_FORCE_AVX2)
+            if (active_kernel() == simd_kernel::Avx2) {
+                return encrypt_blocks<__m256i>(dst, src, first, blocks);
+            }
+            return encrypt_blocks<__m128i>(dst, src, first, blocks);
+#else
+            return encrypt_blocks<__m256i>(dst, src, first, blocks);
+#endif
+#else
+            return encrypt_blocks<__m128i>(dst, src, first, blocks);
+#endif
+        }
+
+        template<typename Vec>
+        static OBFUSCXX_FORCEINLINE void decrypt_blocks(
+            detail::block_window<const volatile std::uint64_t> src, unit_type* dst, std::size_t first, std::size_t count
+        ) {
+            using S = simd<Vec>;
+            constexpr std::size_t ways = interleave<Vec>();
+            std::size_t const last = first + count;
+            std::size_t const begin_block = (first / elements_per_block) & ~(S::lanes - 1);
+            std::size_t const end_block = (last + elements_per_block - 1) / elements_per_block;
+            trace(detail::trace_event::vector_decrypt, ((end_block + S::lanes - 1) & ~(S::lanes - 1)) - begin_block);
+
+            if constexpr (is_outlined) {
+                decrypt_outlined<Vec>(src, dst, first, last, begin_block, end_block);
+            } else {
+                std::size_t i = begin_block;
+                if constexpr (ways > 1) {
+                    std::size_t const end_aligned = (end_block + S::lanes - 1) & ~(S::lanes - 1);
+                    for (; i + (ways * S::lanes) <= end_aligned; i += ways * S::lanes) {
+                        decrypt_lanes<ways, Vec>(src, i, dst, first, last);
+                    }
+                    if constexpr (ways > 2) {
+                        if (i + (2 * S::lanes) <= end_aligned) {
+                            decrypt_lanes<2, Vec>(src, i, dst, first, last);
+                            i += 2 * S::lanes;
+                        }
+                    }
+                }
+                for (; i < end_block; i += S::lanes) {
+                    decrypt_lanes<1, Vec>(src, i, dst, first, last);
+                }
+            }
+        }
+
+        // Decrypts the lane groups of blocks [begin_block, end_block) with the shared kernel, outline_batch blocks
+        // per call, and unpacks the elements in [first, last).
+        template<typename Vec>
+        static OBFUSCXX_FORCEINLINE void decrypt_outlined(
+            detail::block_window<const volatile std::uint64_t> src,
+            unit_type* dst,
+            std::size_t first,
+            std::size_t last,
+            std::size_t begin_block,
+            std::size_t end_block
+        ) {
+            constexpr std::size_t lanes = simd<Vec>::lanes;
+            alignas(64) std::uint64_t out64[outline_batch];
+            for (std::size_t i = begin_block; i < end_block; i += outline_batch) {
+                std::size_t const n =
+                    (end_block - i < outline_batch) ? (end_block - i + lanes - 1) & ~(lanes - 1) : outline_batch;
+                detail::outlined_kernels<sizeof(Vec) * 8>::decrypt(
+                    const_cast<const std::uint64_t*>(src + i), out64, n, engine::schedule
+                );
+                unpack_blocks(out64, n, i, dst, first, last);
+            }
+        }
+
+        // Number of independent vectors kept in flight per round. Each cipher round is a serial dependency chain, so
+        // decrypting two or four vectors side by side fills the otherwise idle ALU ports. Small arrays that cannot
+        // fill that many vectors stay at one, as does Low, whose two rounds are too short a chain to be worth it.
+        template<typename Vec> static constexpr std::size_t interleave() {
+            constexpr std::size_t vectors = storage_size / simd<Vec>::lanes;
+            if constexpr (effective_level == obf_level::Low) {
+                return 1;
+            }
+            return vectors >= 4 ? 4 : vectors >= 2 ? 2 : 1;
+        }
+
+        template<std::size_t Ways, typename Vec>
+        static OBFUSCXX_FORCEINLINE void decrypt_lanes(
+            detail::block_window<const volatile std::uint64_t> src,
+            std::size_t i,
+            unit_type* dst,
+            std::size_t first,
+            std::size_t last
+        ) {
+            if constexpr (Ways == 4) {
+                vec_pair<Vec> a;
+                vec_pair<Vec> b;
+                vec_pair<Vec> c;
+                vec_pair<Vec> d;
+                decrypt_pairs<Vec>(src, i, dst, first, last, a, b, c, d);
+            } else if constexpr (Ways == 2) {
+                vec_pair<Vec> a;
+                vec_pair<Vec> b;
+                decrypt_pairs<Vec>(src, i, dst, first, last, a, b);
+            } else {
+                using S = simd<Vec>;
+                Vec v0_vec;
+                Vec v1_vec;
+                load_lanes(src, i, v0_vec, v1_vec);
+
+                engine::decrypt_rounds(v0_vec, v1_vec);
+
+                alignas(sizeof(Vec)) std::uint64_t out64[S::lanes];
+                S::store_blocks(out64, v0_vec, v1_vec);
+                apply_keystream<Vec>(out64, src, i);
+
+                unpack_blocks(out64, S::lanes, i, dst, first, last);
+            }
+        }
+
+        template<typename Vec, typename... Pairs>
+        static OBFUSCXX_FORCEINLINE void decrypt_pairs(
+            detail::block_window<const volatile std::uint64_t> src,
+            std::size_t i,
+            unit_type* dst,
+            std::size_t first,
+            std::size_t last,
+            Pairs&... pairs
+        ) {
+            using S = simd<Vec>;
+            std::size_t block = i;
+            ((load_lanes(src, block, pairs.v0, pairs.v1), block += S::lanes), ...);
+
+            engine::decrypt_rounds_interleaved(pairs...);
+
+            alignas(sizeof(Vec)) std::uint64_t out64[S::lanes];
+            block = i;
+            ((S::store_blocks(out64, pairs.v0, pairs.v1),
+              apply_keystream<Vec>(out64, src, block),
+              unpack_blocks(out64, S::lanes, block, dst, first, last),
+              block += S::lanes),
+             ...);
+        }
+
+        // Inputs of the vector rounds for blocks [i, i + S::lanes): the stored ciphertext, or in counter mode the
+        // counters of those blocks, which need no memory access at all.
+        template<typename Vec>
+        static OBFUSCXX_FORCEINLINE void load_lanes(
+            detail::block_window<const volatile std::uint64_t> src, std::size_t i, Vec& v0, Vec& v1
+        ) {
+            using S = simd<Vec>;
+            if constexpr (engine::counter_mode) {
+                v0 = S::vxor(
+                    S::broadcast(static_cast<std::uint32_t>(engine::nonce)),
+                    S::vadd(S::broadcast(static_cast<std::uint32_t>(i)), S::load(detail::lane_ids))
+                );
+                v1 = S::broadcast(static_cast<std::uint32_t>(engine::nonce >> 32));
+            } else {
+                S::load_blocks(const_cast<const std::uint64_t*>(src + i), v0, v1);
+            }
+        }
+
+        template<typename Vec>
+        static OBFUSCXX_FORCEINLINE void apply_keystream(
+            std::uint64_t* blocks, detail::block_window<const volatile std::uint64_t> src, std::size_t i
+        ) {
+            if constexpr (engine::counter_mode) {
+                const std::uint64_t* data = const_cast<const std::uint64_t*>(src + i);
+                for (std::size_t j{}; j < simd<Vec>::lanes; ++j) {
+                    blocks[j] ^= data[j];
+                }
+            }
+        }
+
+        // Encrypts whole groups of S::lanes blocks of [first, first + blocks) from src[0, ...) and returns how many
+        // blocks were written; the caller handles the remainder with the scalar encryptor.
+        template<typename Vec>
+        static OBFUSCXX_FORCEINLINE std::size_t encrypt_blocks(
+            detail::block_window<volatile std::uint64_t> dst,
+            const unit_type* src,
+            std::size_t first,
+            std::size_t blocks
+        ) {
+            using S = simd<Vec>;
+            std::size_t i = first;
+
+            for (; i + S::lanes <= first + blocks; i += S::lanes) {
+                alignas(sizeof(Vec)) std::uint64_t in64[S::lanes];
+                for (std::size_t j{}; j < S::lanes; ++j) {
+                    in64[j] = pack(0, src + ((i - first + j) * elements_per_block), elements_per_block);
+                }
+
+                Vec v0_vec;
+                Vec v1_vec;
+                if constexpr (engine::counter_mode) {
+                    load_lanes(dst, i, v0_vec, v1_vec);
+                    engine::encrypt_rounds(v0_vec, v1_vec);
+
+                    alignas(sizeof(Vec)) std::uint64_t key64[S::lanes];
+                    S::store_blocks(key64, v0_vec, v1_vec);
+                    for (std::size_t j{}; j < S::lanes; ++j) {
+                        dst[i + j] = in64[j] ^ key64[j];
+                    }
+                } else {
+                    S::load_blocks(in64, v0_vec, v1_vec);
+                    engine::encrypt_rounds(v0_vec, v1_vec);
+                    S::store_blocks(const_cast<std::uint64_t*>(dst + i), v0_vec, v1_vec);
+                }
+            }
+            trace(detail::trace_event::runtime_encrypt, i - first);
+            return i - first;
+        }
+
+#if OBFUSCXX_HAS_DISPATCH
+        static OBFUSCXX_KERNEL_AVX2 void decrypt_blocks_avx2(
+            detail::block_window<const volatile std::uint64_t> src, unit_type* dst, std::size_t first, std::size_t count
+        ) {
+            decrypt_blocks<__m256i>(src, dst, first, count);
+        }
+
+        static OBFUSCXX_KERNEL_AVX2 std::size_t encrypt_blocks_avx2(
+            detail::block_window<volatile std::uint64_t> dst,
+            const unit_type* src,
+            std::size_t first,
+            std::size_t blocks
+        ) {
+            return encrypt_blocks<__m256i>(dst, src, first, blocks);
+        }
+
+        static OBFUSCXX_KERNEL_AVX512 void decrypt_blocks_avx512(
+            detail::block_window<const volatile std::uint64_t> src, unit_type* dst, std::size_t first, std::size_t count
+        ) {
+            decrypt_blocks<__m512i>(src, dst, first, count);
+        }
+
+        static OBFUSCXX_KERNEL_AVX512 std::size_t encrypt_blocks_avx512(
+            detail::block_window<volatile std::uint64_t> dst,
+            const unit_type* src,
+            std::size_t first,
+            std::size_t blocks
+        ) {
+            return encrypt_blocks<__m512i>(dst, src, first, blocks);
+        }
+#endif
+
+        static constexpr std::uint64_t to_uint64(Type value) {
+            if constexpr (std::is_pointer_v<Type>) {
+                return reinterpret_cast<std::uint64_t>(value);
+            } else if constexpr (std::is_floating_point_v<Type>) {
+                if constexpr (sizeof(Type) == 4) {
+                    return __builtin_bit_cast(std::uint32_t, value);
+                } else {
+                    return __builtin_bit_cast(std::uint64_t, value);
+                }
+            } else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+                return static_cast<std::uint64_t>(value);
+            } else {
+                return to_words(value).words[0];
+            }
+        }
+
+        static OBFUSCXX_FORCEINLINE Type from_uint64(std::uint64_t value) {
+            if constexpr (std::is_pointer_v<Type>) {
+                return reinterpret_cast<Type>(value);
+            } else if constexpr (std::is_floating_point_v<Type>) {
+                if constexpr (sizeof(Type) == 4) {
+                    return __builtin_bit_cast(Type, static_cast<std::uint32_t>(value));
+                } else {
+                    return __builtin_bit_cast(Type, value);
+                }
+            } else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+                return static_cast<Type>(value);
+            } else {
+                return from_words(&value);
+            }
+        }
+
+        struct word_image {
+            std::uint64_t words[words_per_element];
+        };
+
+        struct byte_image {
+            unsigned char bytes[sizeof(Type)];
+        };
+
+        // Little-endian words of value's object representation. Bytes past sizeof(Type) stay zero, so equal values
+        // always give equal ciphertext.
+        static constexpr word_image to_words(const Type& value) {
+            if constexpr (sizeof(Type) == sizeof(word_image)) {
+                return __builtin_bit_cast(word_image, value);
+            } else {
+                auto const image = __builtin_bit_cast(byte_image, value);
+                word_image result{};
+                for (std::size_t j{}; j < sizeof(Type); ++j) {
+                    result.words[j / 8] |= static_cast<std::uint64_t>(image.bytes[j]) << ((j % 8) * 8);
+                }
+                return result;
+            }
+        }
+
+        static OBFUSCXX_FORCEINLINE Type from_words(const std::uint64_t* words) {
+            if constexpr (sizeof(Type) == sizeof(word_image)) {
+                word_image image;
+                for (std::size_t j{}; j < words_per_element; ++j) {
+                    image.words[j] = words[j];
+                }
+                return __builtin_bit_cast(Type, image);
+            } else {
+                byte_image image;
+                for (std::size_t j{}; j < sizeof(Type); ++j) {
+                    image.bytes[j] = static_cast<unsigned char>(words[j / 8] >> ((j % 8) * 8));
+                }
+                return __builtin_bit_cast(Type, image);
+            }
+        }
+
+        static constexpr std::uint64_t insert(std::uint64_t block, unit_type value, std::size_t lane) {
+            if constexpr (is_wide) {
+                return value;
+            } else {
+                std::size_t const shift = lane * element_bits;
+                return (block & ~(element_mask << shift)) | ((to_uint64(value) & element_mask) << shift);
+            }
+        }
+
+        static OBFUSCXX_FORCEINLINE unit_type extract(std::uint64_t block, std::size_t lane) {
+            if constexpr (is_wide) {
+                return block;
+            } else {
+                return from_uint64((block >> (lane * element_bits)) & element_mask);
+            }
+        }
+
+        static constexpr std::uint64_t pack(std::uint64_t block, const unit_type* values, std::size_t count) {
+            for (std::size_t j{}; j < count; ++j) {
+                block = insert(block, values[j], j);
+            }
+            return block;
+        }
+
+        static OBFUSCXX_FORCEINLINE void unpack_blocks(
+            const std::uint64_t* blocks,
+            std::size_t n,
+            std::size_t first_block,
+            unit_type* dst,
+            std::size_t first,
+            std::size_t last
+        ) {
+            for (std::size_t j{}; j < n; ++j) {
+                for (std::size_t k{}; k < elements_per_block; ++k) {
+                    std::size_t const index = ((first_block + j) * elements_per_block) + k;
+                    if (index >= last) {
+                        return;
+                    }
+                    if (index >= first) {
+                        dst[index - first] = extract(blocks[j], k);
+                    }
+                }
+            }
+        }
+
+    public:
+        // The site parameters record where an instance is constructed; they carry data only in OBFUSCXX_PROFILE builds.
+        explicit consteval obfuscxx(passkey, detail::site_location site = detail::site_location::current()) {
+            for (std::size_t i{}; i < block_count; ++i) {
+                storage_[i] = seed ^ iv[i & iv_size];
+            }
+#if defined(OBFUSCXX_PROFILE)
+            site_file_ = site.file_name();
+            site_line_ = site.line();
+#else
+            static_cast<void>(site);
+#endif
+        }
+
+        explicit consteval obfuscxx(Type val, detail::site_location site = detail::site_location::current())
+            : obfuscxx(passkey{}, site) {
+            if constexpr (is_wide) {
+                store_element(0, val);
+            } else {
+                storage_[0] = encrypt(val);
+            }
+        }
+
+        explicit consteval obfuscxx(Type (&arr)[Size], detail::site_location site = detail::site_location::current())
+            : obfuscxx(passkey{}, site) {
+            store(arr, Size);
+        }
+
+        explicit consteval obfuscxx(
+            const Type (&arr)[Size], detail::site_location site = detail::site_location::current()
+        )
+            : obfuscxx(passkey{}, site) {
+            store(arr, Size);
+        }
+
+        consteval obfuscxx(
+            const std::initializer_list<Type>& list, detail::site_location site = detail::site_location::current()
+        )
+            : obfuscxx(passkey{}, site) {
+            store(list.begin(), list.size());
+        }
+
+        // Level the instance is encrypted with: Level, unless OBFUSCXX_LEVEL_OVERRIDES lists this instantiation.
+        static constexpr obf_level level() {
+            return effective_level;
+        }
+
+        OBFUSCXX_FORCEINLINE Type get() const
+            requires is_single
+        {
+            profile_hit();
+            if constexpr (is_wide) {
+                return load_element(0);
+            } else {
+                volatile const std::uint64_t* ptr = &storage_[0];
+                std::uint64_t val = *ptr;
+                return decrypt(val);
+            }
+        }
+
+        OBFUSCXX_FORCEINLINE Type get(std::size_t i) const
+            requires is_array
+        {
+            profile_hit();
+            if constexpr (is_wide) {
+                return load_element(i);
+            } else {
+                volatile const std::uint64_t* ptr = &storage_[i / elements_per_block];
+                std::uint64_t val = *ptr;
+                return extract(decrypt_block(val, i / elements_per_block), i % elements_per_block);
+            }
+        }
+
+        OBFUSCXX_FORCEINLINE void copy_to(Type* out, std::size_t count) const
+            requires is_array
+        {
+            copy_to(out, 0, count);
+        }
+
+        // Decrypts elements [offset, offset + count) into out. Only the storage groups covering the range are
+        // decrypted; the unaligned head and tail of the range are trimmed while unpacking.
+        OBFUSCXX_FORCEINLINE void copy_to(Type* out, std::size_t offset, std::size_t count) const
+            requires is_array
+        {
+            profile_hit();
+            if (offset >= Size) {
+                return;
+            }
+            std::size_t effective_count = (count < Size - offset) ? count : Size - offset;
+            if (effective_count == 0) {
+                return;
+            }
+            if constexpr (is_wide) {
+                copy_wide(out, offset, effective_count);
+            } else {
+                decrypt_vectorized(storage_, out, offset, effective_count);
+            }
+        }
+
+        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE void set(Type val)
+            requires is_single
+        {
+            if constexpr (is_wide) {
+                store_element(0, val);
+            } else {
+                storage_[0] = encrypt(val);
+            }
+        }
+
+        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE void set(Type val, std::size_t i)
+            requires is_array
+        {
+            if constexpr (is_packed) {
+                std::uint64_t const block = load_partial_block(i / elements_per_block);
+                storage_[i / elements_per_block] =
+                    encrypt_block(insert(block, val, i % elements_per_block), i / elements_per_block);
+            } else if constexpr (is_wide) {
+                store_element(i, val);
+            } else {
+                storage_[i] = encrypt(val, i);
+            }
+        }
+
+        OBFUSCXX_FORCEINLINE void set(const std::initializer_list<Type>& list)
+            requires is_array
+        {
+            assign(list.begin(), list.size());
+        }
+
+        OBFUSCXX_FORCEINLINE void assign(const Type* values, std::size_t count)
+            requires is_array
+        {
+            count = (count < Size) ? count : Size;
+            if constexpr (is_wide) {
+                store(values, count);
+            } else {
+                std::size_t const done = encrypt_vectorized(storage_, values, 0, count / elements_per_block);
+                store(values, count, done * elements_per_block);
+            }
+        }
+
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+        OBFUSCXX_FORCEINLINE void assign(std::span<const Type> values)
+            requires is_array
+        {
+            assign(values.data(), values.size());
+        }
+#endif
+
+        OBFUSCXX_FORCEINLINE Type operator()() const
+            requires is_single
+        {
+            return get();
+        }
+
+        OBFUSCXX_FORCEINLINE Type operator[](std::size_t i) const
+            requires is_array
+        {
+            return get(i);
+        }
+
+        // Instances of the same type share the key and the cipher is deterministic, so equal plaintext bits mean equal
+        // ciphertext. Where equal bits are also the only way to be equal, the blocks are compared without decrypting.
+        // Other types, floating point among them (0.0f == -0.0f, NaN != NaN), decrypt both sides chunk by chunk with
+        // the vector kernels and compare the values with the type's own operator==.
+        OBFUSCXX_FORCEINLINE bool operator==(const obfuscxx& other) const {
+            if constexpr (compares_bitwise) {
+                std::uint64_t diff{};
+                for (std::size_t i{}; i < block_count; ++i) {
+                    diff |= storage_[i] ^ other.storage_[i];
+                }
+                return diff == 0;
+            } else if constexpr (is_single) {
+                return get() == other.get();
+            } else {
+                constexpr std::size_t chunk_size = (default_chunk < Size) ? default_chunk : Size;
+                std::remove_cv_t<Type> lhs[chunk_size];
+                std::remove_cv_t<Type> rhs[chunk_size];
+                bool equal = true;
+                for (std::size_t offset{}; equal && offset < Size; offset += chunk_size) {
+                    std::size_t const count = (Size - offset < chunk_size) ? Size - offset : chunk_size;
+                    copy_to(lhs, offset, count);
+                    other.copy_to(rhs, offset, count);
+                    for (std::size_t i{}; i < count; ++i) {
+                        equal &= lhs[i] == rhs[i];
+                    }
+                }
+                detail::secure_wipe(lhs, sizeof(lhs));
+                detail::secure_wipe(rhs, sizeof(rhs));
+                return equal;
+            }
+        }
+
+        // Hash of the ciphertext, stable for equal contents of the same type; backs std::hash<obfuscxx>. Only offered
+        // where operator== compares ciphertext, since equal floating-point values can differ in their bits.
+        OBFUSCXX_FORCEINLINE std::size_t ciphertext_hash() const
+            requires compares_bitwise
+        {
+            std::uint64_t hash = seed;
+            for (std::size_t i{}; i < block_count; ++i) {
+                hash = detail::splitmix64(hash ^ storage_[i]);
+            }
+            return static_cast<std::size_t>(hash);
+        }
+
+        OBFUSCXX_FORCEINLINE obfuscxx& operator=(Type val)
+            requires is_single
+        {
+            set(val);
+            return *this;
+        }
+
+        OBFUSCXX_FORCEINLINE obfuscxx& operator=(const std::initializer_list<Type>& list)
+            requires is_array
+        {
+            set(list);
+            return *this;
+        }
+
+        OBFUSCXX_FORCEINLINE bool operator!=(const obfuscxx& rhs) const {
+            return !operator==(rhs);
+        }
+
+        OBFUSCXX_FORCEINLINE operator Type() const
+            requires is_single
+        {
+            return get();
+        }
+
+        OBFUSCXX_FORCEINLINE bool operator<(const obfuscxx& rhs) const {
+            return get() < rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE bool operator>(const obfuscxx& rhs) const {
+            return get() > rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE bool operator<=(const obfuscxx& rhs) const {
+            return get() <= rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE bool operator>=(const obfuscxx& rhs) const {
+            return get() >= rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE Type operator+(const obfuscxx& rhs) const {
+            return get() + rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE Type operator-(const obfuscxx& rhs) const {
+            return get() - rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE Type operator*(const obfuscxx& rhs) const
+            requires(!is_single_pointer)
+        {
+            return get() * rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE Type operator/(const obfuscxx& rhs) const
+            requires(!is_single_pointer)
+        {
+            return get() / rhs.get();
+        }
+
+        OBFUSCXX_FORCEINLINE obfuscxx& operator+=(const obfuscxx& rhs)
+            requires(!is_single_pointer)
+        {
+            set(get() + rhs.get());
+            return *this;
+        }
+
+        OBFUSCXX_FORCEINLINE obfuscxx& operator-=(const obfuscxx& rhs)
+            requires(!is_single_pointer)
+        {
+            set(get() - rhs.get());
+            return *this;
+        }
+
+        OBFUSCXX_FORCEINLINE Type operator->()
+            requires is_single_pointer
+        {
+            return get();
+        }
+
+        OBFUSCXX_FORCEINLINE Type& operator*()
+            requires is_single_pointer
+        {
+            return *get();
+        }
+
+        // Random-access iterator that decrypts a whole group of storage_multiple blocks with the vector kernel on
+        // first access and serves the following elements of that group from its buffer. The plaintext stays with the
+        // iterator that decrypted it: copies start empty and refill on their first access, and the buffer is wiped on
+        // destruction. Prefer ++it and it[n] to it++ and *(it + n) in loops, which decrypt in a fresh copy.
+        class iterator {
+        public:
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+#endif
+            using value_type = std::remove_cv_t<Type>;
+            using difference_type = std::ptrdiff_t;
+            using reference = Type;
+
+            iterator() = default;
+            iterator(const obfuscxx* parent, std::size_t index) : parent_(parent), index_(index) {}
+
+            iterator(const iterator& other) : parent_(other.parent_), index_(other.index_) {}
+
+            iterator& operator=(const iterator& other) {
+                wipe();
+                parent_ = other.parent_;
+                index_ = other.index_;
+                return *this;
+            }
+
+            ~iterator() {
+                wipe();
+            }
+
+            Type operator*() const {
+                return load(index_);
+            }
+
+            Type operator[](difference_type n) const {
+                return load(static_cast<std::size_t>(static_cast<difference_type>(index_) + n));
+            }
+
+            iterator& operator++() {
+                ++index_;
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++index_;
+                return tmp;
+            }
+            iterator& operator--() {
+                --index_;
+                return *this;
+            }
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --index_;
+                return tmp;
+            }
+
+            iterator& operator+=(difference_type n) {
+                index_ = static_cast<std::size_t>(static_cast<difference_type>(index_) + n);
+                return *this;
+            }
+            iterator& operator-=(difference_type n) {
+                return *this += -n;
+            }
+
+            friend iterator operator+(iterator it, difference_type n) {
+                return it += n;
+            }
+            friend iterator operator+(difference_type n, iterator it) {
+                return it += n;
+            }
+            friend iterator operator-(iterator it, difference_type n) {
+                return it -= n;
+            }
+            friend difference_type operator-(const iterator& lhs, const iterator& rhs) {
+                return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+            }
+
+            bool operator==(const iterator& other) const {
+                return index_ == other.index_;
+            }
+            bool operator<(const iterator& other) const {
+                return index_ < other.index_;
+            }
+            bool operator>(const iterator& other) const {
+                return index_ > other.index_;
+            }
+            bool operator<=(const iterator& other) const {
+                return index_ <= other.index_;
+            }
+            bool operator>=(const iterator& other) const {
+                return index_ >= other.index_;
+            }
+
+        private:
+            static constexpr std::size_t no_group = ~std::size_t{};
+
+            Type load(std::size_t index) const {
+                std::size_t const group = index / group_elements;
+                if (group != group_) {
+                    parent_->decrypt_group(group, buffer_);
+                    group_ = group;
+                }
+                return buffer_[index % group_elements];
+            }
+
+            void wipe() {
+                if (group_ != no_group) {
+                    detail::secure_wipe(buffer_, sizeof(buffer_));
+                    group_ = no_group;
+                }
+            }
+
+            const obfuscxx* parent_{};
+            std::size_t index_{};
+            mutable std::size_t group_{no_group};
+            // Only read after decrypt_group() has filled it, so it is not value-initialized.
+            mutable value_type buffer_[group_elements];
+        };
+
+        iterator begin() const
+            requires is_array
+        {
+            return {this, 0};
+        }
+        iterator end() const
+            requires is_array
+        {
+            return {this, Size};
+        }
+
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+        auto view() const
             requires is_array
         {
-            for (std::size_t i{}; const auto& val : list) {
-                if (i < Size) {
-                    storage_[i++] = encrypt(val);
+            return std::ranges::subrange<iterator>(begin(), end());
+        }
+
+        // Decrypts the array Chunk elements at a time into a reused stack buffer and passes each chunk to fn as a
+        // std::span<const Type>. Peak memory is one chunk regardless of Size. If fn returns bool, returning false
+        // stops the walk early.
+        template<std::size_t Chunk = default_chunk, class Fn>
+        OBFUSCXX_FORCEINLINE void for_each_chunk(Fn&& fn) const
+            requires(is_array && Chunk != 0)
+        {
+            decrypt_chunks<Chunk>([&](const Type* data, std::size_t count) {
+                return invoke_visitor(fn, std::span<const Type>(data, count));
+            });
+        }
+#endif
+
+        // Per-element counterpart of for_each_chunk(), also available in kernel builds.
+        template<std::size_t Chunk = default_chunk, class Fn>
+        OBFUSCXX_FORCEINLINE void visit(Fn&& fn) const
+            requires(is_array && Chunk != 0)
+        {
+            decrypt_chunks<Chunk>([&](const Type* data, std::size_t count) {
+                for (std::size_t i{}; i < count; ++i) {
+                    if (!invoke_visitor(fn, data[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        }
+
+        static constexpr std::size_t size() {
+            return Size;
+        }
+
+        // Decrypts once into a handle that wipes the plaintext when it goes out of scope:
+        // auto plain = cfg.lock(); for (...) use(*plain);
+        OBFUSCXX_FORCEINLINE scoped_plain<std::remove_cv_t<Type>, Size> lock() const {
+            return scoped_plain<std::remove_cv_t<Type>, Size>(*this);
+        }
+
+        template<class CharType, std::size_t N> struct string_copy {
+        private:
+            static constexpr bool is_char = std::is_same_v<CharType, char> || std::is_same_v<CharType, const char>;
+            static constexpr bool is_wchar =
+                std::is_same_v<CharType, wchar_t> || std::is_same_v<CharType, const wchar_t>;
+
+        public:
+            operator const char*() const
+                requires is_char
+            {
+                return data;
+            }
+            operator const wchar_t*() const
+                requires is_wchar
+            {
+                return data;
+            }
+
+            const CharType* c_str() const {
+                return data;
+            }
+            const CharType& operator[](std::size_t i) const {
+                return data[i];
+            }
+
+            const CharType* begin() const {
+                return data;
+            }
+            const CharType* end() const {
+                return data + N;
+            }
+
+            constexpr std::size_t size() const {
+                return N;
+            }
+
+            CharType data[N];
+        };
+
+        template<class ArrayType, std::size_t N> struct array_copy {
+            const ArrayType* get() const {
+                return data;
+            }
+
+            const ArrayType* begin() const {
+                return data;
+            }
+            const ArrayType* end() const {
+                return data + N;
+            }
+
+            constexpr std::size_t size() const {
+                return N;
+            }
+            constexpr std::size_t size_bytes() const {
+                return N * sizeof(ArrayType);
+            }
+
+            ArrayType data[N];
+        };
+
+        OBFUSCXX_FORCEINLINE string_copy<Type, Size> to_string() const
+            requires(is_char || is_wchar)
+        {
+            string_copy<Type, Size> result{};
+            if constexpr (is_array) {
+                copy_to(result.data, Size);
+            } else {
+                result.data[0] = get();
+            }
+            return result;
+        }
+
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+        // Decrypts into the calling thread's plaintext arena instead of a copy on the caller's stack. The view is
+        // null-terminated and stays valid until the enclosing plaintext_scope closes, or until the thread exits when
+        // there is none, so repeated calls belong inside a scope.
+        OBFUSCXX_FORCEINLINE std::basic_string_view<std::remove_cv_t<Type>> to_string_view() const
+            requires(is_char || is_wchar)
+        {
+            using char_type = std::remove_cv_t<Type>;
+            auto* data = static_cast<char_type*>(detail::thread_arena.allocate((Size + 1) * sizeof(char_type)));
+            if constexpr (is_array) {
+                copy_to(data, Size);
+            } else {
+                data[0] = get();
+            }
+            data[Size] = char_type{};
+            return {data, data[Size - 1] == char_type{} ? Size - 1 : Size};
+        }
+#endif
+
+        OBFUSCXX_FORCEINLINE array_copy<Type, Size> to_array() const
+            requires(is_array)
+        {
+            array_copy<Type, Size> result{};
+            copy_to(result.data, Size);
+            return result;
+        }
+
+        // Elements past the end of the array are left value-initialized.
+        template<std::size_t Count>
+        OBFUSCXX_FORCEINLINE array_copy<Type, Count> decrypt_range(std::size_t offset) const
+            requires(is_array && Count != 0)
+        {
+            array_copy<Type, Count> result{};
+            copy_to(result.data, offset, Count);
+            return result;
+        }
+
+        // Always null-terminated, even when the range runs past the end of the string.
+        template<std::size_t Count>
+        OBFUSCXX_FORCEINLINE string_copy<Type, Count + 1> substr(std::size_t offset) const
+            requires(is_array && (is_char || is_wchar))
+        {
+            string_copy<Type, Count + 1> result{};
+            copy_to(result.data, offset, Count);
+            return result;
+        }
+
+    private:
+        template<std::size_t Chunk, class Fn> OBFUSCXX_FORCEINLINE void decrypt_chunks(Fn&& fn) const {
+            constexpr std::size_t chunk_size = (Chunk < Size) ? Chunk : Size;
+            std::remove_cv_t<Type> buffer[chunk_size];
+
+            for (std::size_t offset{}; offset < Size; offset += chunk_size) {
+                std::size_t const count = (Size - offset < chunk_size) ? Size - offset : chunk_size;
+                copy_to(buffer, offset, count);
+                if (!fn(static_cast<const Type*>(buffer), count)) {
+                    return;
+                }
+            }
+        }
+
+        template<class Fn, class Arg> static OBFUSCXX_FORCEINLINE bool invoke_visitor(Fn& fn, const Arg& arg) {
+            if constexpr (std::is_same_v<decltype(fn(arg)), bool>) {
+                return fn(arg);
+            } else {
+                fn(arg);
+                return true;
+            }
+        }
+
+        OBFUSCXX_FORCEINLINE void decrypt_group(std::size_t group, std::remove_cv_t<Type>* out) const {
+            copy_to(out, group * group_elements, group_elements);
+        }
+
+        // Decrypts a packed block for a read-modify-write. Lanes past the end of the array are cleared, as they are
+        // for compile-time initialized instances, so equal elements always give equal ciphertext.
+        OBFUSCXX_FORCEINLINE std::uint64_t load_partial_block(std::size_t index) const {
+            std::uint64_t block = decrypt_block(storage_[index], index);
+            if constexpr (Size % elements_per_block != 0) {
+                if (index == block_count - 1) {
+                    block &= (1ULL << ((Size % elements_per_block) * element_bits)) - 1;
+                }
+            }
+            return block;
+        }
+
+        // Elements of a wide type are decrypted with the vector kernel even when only one is read, since its words are
+        // consecutive blocks that fill at most a few lanes.
+        OBFUSCXX_FORCEINLINE Type load_element(std::size_t i) const {
+            std::uint64_t words[words_per_element];
+            decrypt_vectorized(storage_, words, i * words_per_element, words_per_element);
+            return from_words(words);
+        }
+
+        OBFUSCXX_FORCEINLINE void copy_wide(Type* out, std::size_t offset, std::size_t count) const {
+            constexpr std::size_t chunk = storage_multiple;
+            std::uint64_t words[chunk * words_per_element];
+            for (std::size_t done{}; done < count; done += chunk) {
+                std::size_t const n = (count - done < chunk) ? count - done : chunk;
+                decrypt_vectorized(storage_, words, (offset + done) * words_per_element, n * words_per_element);
+                for (std::size_t k{}; k < n; ++k) {
+                    out[done + k] = from_words(words + (k * words_per_element));
+                }
+            }
+        }
+
+        constexpr void store_element(std::size_t i, const Type& value) {
+            word_image const image = to_words(value);
+            for (std::size_t j{}; j < words_per_element; ++j) {
+                std::size_t const index = (i * words_per_element) + j;
+                storage_[index] = encrypt_block(image.words[j], index);
+            }
+        }
+
+        constexpr void store(const Type* values, std::size_t count, std::size_t first = 0) {
+            count = (count < Size) ? count : Size;
+            if constexpr (is_wide) {
+                for (; first < count; ++first) {
+                    store_element(first, values[first]);
+                }
+            } else {
+                for (; first < count; first += elements_per_block) {
+                    std::size_t const n = (count - first < elements_per_block) ? count - first : elements_per_block;
+                    std::uint64_t block = 0;
+                    if (n < elements_per_block && !std::is_constant_evaluated()) {
+                        block = load_partial_block(first / elements_per_block);
+                    }
+                    storage_[first / elements_per_block] =
+                        encrypt_block(pack(block, values + first, n), first / elements_per_block);
+                }
+            }
+        }
+
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+        // Reads a block with a relaxed atomic load, so it may run while an obfuscxx_seqlock writer stores to it. The
+        // seqlock decides afterwards whether what was read is consistent.
+        static OBFUSCXX_FORCEINLINE std::uint64_t load_relaxed(const OBFUSCXX_VOLATILE std::uint64_t& block) {
+            return std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(block)).load(std::memory_order_relaxed);
+        }
+#endif
+
+        OBFUSCXX_FORCEINLINE void profile_hit() const {
+#if defined(OBFUSCXX_PROFILE)
+            detail::profile_data.hit(site_key, site_file_, site_line_, Level, Size);
+#endif
+        }
+
+        alignas(storage_alignment) OBFUSCXX_VOLATILE std::uint64_t storage_[storage_size]{};
+#if defined(OBFUSCXX_PROFILE)
+        const char* site_file_{};
+        std::uint32_t site_line_{};
+#endif
+    };
+
+    // Read-only view over ciphertext produced outside the compiler, typically a header generated by the obfuscxx_embed
+    // CMake function. The blocks use exactly the layout obfuscxx<Type, Size, Level, Entropy> stores, so they are
+    // decrypted in place by the same kernels without ever passing through a consteval constructor. The storage has to
+    // be 64-byte aligned and padded to a multiple of 16 blocks.
+    template<class Type, std::size_t Size, obf_level Level, std::uint64_t Entropy> class obfuscxx_blob {
+        using cipher = obfuscxx<Type, Size, Level, Entropy>;
+        static_assert(Size > 1, "obfuscxx_blob holds arrays; use obfuscxx for single values");
+        static_assert(sizeof(Type) <= 8, "obfuscxx_blob holds elements of at most eight bytes");
+
+    public:
+        static constexpr std::size_t required_blocks = cipher::storage_size;
+
+        template<std::size_t N>
+        constexpr explicit obfuscxx_blob(const std::uint64_t (&storage)[N]) : storage_(storage) {
+            static_assert(N >= required_blocks, "obfuscxx_blob storage is smaller than the obfuscxx layout");
+        }
+
+        OBFUSCXX_FORCEINLINE Type get(std::size_t i) const {
+            volatile const std::uint64_t* ptr = &storage_[i / cipher::elements_per_block];
+            std::uint64_t val = *ptr;
+            return cipher::extract(
+                cipher::decrypt_block(val, i / cipher::elements_per_block), i % cipher::elements_per_block
+            );
+        }
+
+        OBFUSCXX_FORCEINLINE Type operator[](std::size_t i) const {
+            return get(i);
+        }
+
+        OBFUSCXX_FORCEINLINE void copy_to(Type* out, std::size_t count) const {
+            copy_to(out, 0, count);
+        }
+
+        OBFUSCXX_FORCEINLINE void copy_to(Type* out, std::size_t offset, std::size_t count) const {
+            if (offset >= Size) {
+                return;
+            }
+            std::size_t effective_count = (count < Size - offset) ? count : Size - offset;
+            if (effective_count != 0) {
+                cipher::decrypt_vectorized(storage_, out, offset, effective_count);
+            }
+        }
+
+        static constexpr std::size_t size() {
+            return Size;
+        }
+
+    private:
+        const std::uint64_t* storage_;
+    };
+
+    template<class Type, std::size_t Size, obf_level Level, std::uint64_t Entropy, class Cipher>
+    scoped_plain(const obfuscxx<Type, Size, Level, Entropy, Cipher>&) -> scoped_plain<std::remove_cv_t<Type>, Size>;
+
+    namespace detail {
+        // Deliberately not constexpr: reaching either while building an obfuscxx_map fails compilation.
+        void obfuscxx_map_duplicate_key();
+        void obfuscxx_map_key_too_long();
+
+        // Stands in for the key text storage of maps with integer keys, which compare the whole key already.
+        struct no_key_text {};
+    } // namespace detail
+
+    template<class Key, class Value> struct map_entry {
+        Key key;
+        Value value;
+    };
+
+    // Compile-time key/value table. Keys are never stored in plaintext: each slot holds the XTEA ciphertext of the
+    // key's fingerprint (the integer itself, or detail::hash_runtime() for C strings). Slots are placed by open
+    // addressing on that ciphertext with a probe length bounded at compile time, so a lookup encrypts the query once,
+    // compares a few ciphertext blocks and decrypts only the value found.
+    //
+    // The string fingerprint ignores ASCII case and may collide, so string maps also keep each key's text, zero padded
+    // to KeyBytes and encrypted. A fingerprint hit is confirmed by encrypting the query text the same way and
+    // comparing ciphertext, which makes lookups exact and case-sensitive. Keys longer than KeyBytes fail compilation.
+    template<
+        class Key,
+        class Value,
+        std::size_t N,
+        obf_level Level = obf_level::Low,
+        std::uint64_t Entropy = OBFUSCXX_ENTROPY,
+        std::size_t KeyBytes = 32>
+    class obfuscxx_map {
+        static_assert(std::is_integral_v<Key> || std::is_same_v<Key, const char*>,
+                      "obfuscxx_map keys must be integers or C strings");
+        static_assert(N != 0, "obfuscxx_map needs at least one entry");
+        static_assert(KeyBytes != 0 && KeyBytes % 8 == 0, "obfuscxx_map KeyBytes must be a non-zero multiple of 8");
+
+        static constexpr bool is_string_key = std::is_same_v<Key, const char*>;
+        static constexpr std::size_t key_words = KeyBytes / 8;
+
+        static constexpr std::size_t slot_count = [] {
+            std::size_t result = 2;
+            while (result < N * 2) {
+                result <<= 1;
+            }
+            return result;
+        }();
+
+        using key_storage = obfuscxx<std::uint64_t, slot_count, Level, Entropy>;
+        using value_storage = obfuscxx<Value, slot_count, Level, detail::splitmix64(Entropy)>;
+        using text_storage = std::conditional_t<
+            is_string_key,
+            obfuscxx<std::uint64_t, slot_count * key_words, Level, detail::splitmix64(~Entropy)>,
+            detail::no_key_text>;
+
+        struct layout {
+            std::uint64_t keys[slot_count]{};
+            Value values[slot_count]{};
+            std::uint64_t text[is_string_key ? slot_count * key_words : 1]{};
+            bool occupied[slot_count]{};
+            std::size_t max_probe{};
+        };
+
+        static constexpr std::uint64_t fingerprint(Key key) {
+            if constexpr (is_string_key) {
+                return detail::hash_runtime(key);
+            } else {
+                return static_cast<std::uint64_t>(key);
+            }
+        }
+
+        // Packs a C string into zero-padded words. Returns the number of words up to and including the one holding
+        // the terminator (all of them for a key of exactly KeyBytes), or 0 if the key is longer than KeyBytes. Stored
+        // keys are zero padded too, so two keys that agree on those words are equal.
+        static constexpr std::size_t pack_text(const char* key, std::uint64_t (&words)[key_words]) {
+            for (std::size_t i{}; i < key_words; ++i) {
+                words[i] = 0;
+            }
+            std::size_t length{};
+            for (; key[length] != 0; ++length) {
+                if (length == KeyBytes) {
+                    return 0;
+                }
+                words[length / 8] |= std::uint64_t{static_cast<unsigned char>(key[length])} << (length % 8 * 8);
+            }
+            return length == KeyBytes ? key_words : length / 8 + 1;
+        }
+
+        static constexpr std::size_t home_slot(std::uint64_t cipher) {
+            return static_cast<std::size_t>(detail::splitmix64(cipher)) & (slot_count - 1);
+        }
+
+        static consteval layout build(const map_entry<Key, Value> (&entries)[N]) {
+            layout result{};
+            for (std::size_t i{}; i < N; ++i) {
+                std::uint64_t const key = fingerprint(entries[i].key);
+                std::uint64_t const cipher = key_storage::encrypt_block(key);
+                std::uint64_t words[key_words]{};
+                if constexpr (is_string_key) {
+                    if (pack_text(entries[i].key, words) == 0) {
+                        detail::obfuscxx_map_key_too_long();
+                    }
+                }
+                std::size_t probe{};
+                std::size_t slot = home_slot(cipher);
+                for (; result.occupied[slot]; ++probe, slot = (slot + 1) & (slot_count - 1)) {
+                    if (result.keys[slot] == key && same_text(result, slot, words)) {
+                        detail::obfuscxx_map_duplicate_key();
+                    }
+                }
+                result.keys[slot] = key;
+                result.values[slot] = entries[i].value;
+                if constexpr (is_string_key) {
+                    for (std::size_t j{}; j < key_words; ++j) {
+                        result.text[slot * key_words + j] = words[j];
+                    }
+                }
+                result.occupied[slot] = true;
+                result.max_probe = probe > result.max_probe ? probe : result.max_probe;
+            }
+            return result;
+        }
+
+        static constexpr bool same_text(
+            const layout& table, std::size_t slot, const std::uint64_t (&words)[key_words]
+        ) {
+            if constexpr (is_string_key) {
+                for (std::size_t j{}; j < key_words; ++j) {
+                    if (table.text[slot * key_words + j] != words[j]) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        static consteval text_storage make_text(const layout& table) {
+            if constexpr (is_string_key) {
+                return text_storage(table.text);
+            } else {
+                return text_storage{};
+            }
+        }
+
+        struct passkey {
+            explicit passkey() = default;
+        };
+
+        consteval obfuscxx_map(passkey, const layout& table)
+            : keys_(table.keys), values_(table.values), text_(make_text(table)), max_probe_(table.max_probe) {
+            for (std::size_t i{}; i < slot_count; ++i) {
+                occupied_[i] = table.occupied[i];
+            }
+        }
+
+    public:
+        consteval obfuscxx_map(const map_entry<Key, Value> (&entries)[N]) : obfuscxx_map(passkey{}, build(entries)) {}
+
+        OBFUSCXX_FORCEINLINE bool find(Key key, Value& out) const {
+            std::size_t const slot = find_slot(key);
+            if (slot == slot_count) {
+                return false;
+            }
+            out = values_.get(slot);
+            return true;
+        }
+
+        OBFUSCXX_FORCEINLINE Value get(Key key, Value fallback = Value{}) const {
+            find(key, fallback);
+            return fallback;
+        }
+
+        OBFUSCXX_FORCEINLINE bool contains(Key key) const {
+            return find_slot(key) != slot_count;
+        }
+
+        static constexpr std::size_t size() {
+            return N;
+        }
+
+    private:
+        OBFUSCXX_FORCEINLINE std::size_t find_slot(Key key) const {
+            std::uint64_t words[key_words]{};
+            std::size_t used_words{};
+            if constexpr (is_string_key) {
+                used_words = pack_text(key, words);
+                if (used_words == 0) {
+                    return slot_count;
+                }
+            }
+            std::uint64_t const cipher = key_storage::encrypt_block(fingerprint(key));
+            std::size_t slot = home_slot(cipher);
+            for (std::size_t probe{}; probe <= max_probe_; ++probe, slot = (slot + 1) & (slot_count - 1)) {
+                if (occupied_[slot] && keys_.storage_[slot] == cipher && text_matches(slot, words, used_words)) {
+                    return slot;
+                }
+            }
+            return slot_count;
+        }
+
+        // Compares ciphertext with ciphertext, so the stored key text is never decrypted.
+        OBFUSCXX_FORCEINLINE bool text_matches(
+            std::size_t slot, const std::uint64_t (&words)[key_words], std::size_t used_words
+        ) const {
+            if constexpr (is_string_key) {
+                for (std::size_t j{}; j < used_words; ++j) {
+                    std::size_t const index = slot * key_words + j;
+                    if (text_.storage_[index] != text_storage::encrypt_block(words[j], index)) {
+                        return false;
+                    }
                 }
             }
+            return true;
         }
 
-        OBFUSCXX_FORCEINLINE Type operator()() const
-            requires is_single
-        {
-            return get();
-        }
+        key_storage keys_;
+        value_storage values_;
+        text_storage text_;
+        std::size_t max_probe_{};
+        bool occupied_[slot_count]{};
+    };
 
-        OBFUSCXX_FORCEINLINE Type operator[](std::size_t i) const
-            requires is_array
-        {
-            return get(i);
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+    namespace detail {
+        // Spin-wait hint for the seqlock retry loops.
+        OBFUSCXX_FORCEINLINE void cpu_relax() {
+#if defined(__aarch64__) || defined(_M_ARM64)
+#if defined(_MSC_VER) && !defined(__clang__)
+            __yield();
+#else
+            __asm__ volatile("yield");
+#endif
+#else
+            _mm_pause();
+#endif
         }
+    } // namespace detail
 
-        OBFUSCXX_FORCEINLINE obfuscxx& operator=(Type val)
-            requires is_single
-        {
-            set(val);
-            return *this;
+    // Single obfuscated value whose ciphertext block lives in a std::atomic, so threads can read and write it without
+    // a lock. Every operation works on the whole encrypted word: compare_exchange compares the ciphertext of
+    // `expected`, which is equivalent to a bitwise comparison of the plaintext because the cipher is deterministic.
+    template<
+        class Type,
+        obf_level Level = obf_level::Low,
+        std::uint64_t Entropy = OBFUSCXX_ENTROPY,
+        class Cipher = default_cipher>
+    class obfuscxx_atomic {
+        using cipher = obfuscxx<Type, 1, Level, Entropy, Cipher>;
+        static_assert(sizeof(Type) <= 8, "obfuscxx_atomic holds values of at most eight bytes");
+
+    public:
+        explicit consteval obfuscxx_atomic(Type val) : storage_(cipher::encrypt(val)) {}
+
+        obfuscxx_atomic(const obfuscxx_atomic&) = delete;
+        obfuscxx_atomic& operator=(const obfuscxx_atomic&) = delete;
+
+        OBFUSCXX_FORCEINLINE Type load(std::memory_order order = std::memory_order_seq_cst) const {
+            return cipher::decrypt(storage_.load(order));
         }
 
-        OBFUSCXX_FORCEINLINE obfuscxx& operator=(const std::initializer_list<Type>& list)
-            requires is_array
-        {
-            set(list);
-            return *this;
+        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE void store(
+            Type val, std::memory_order order = std::memory_order_seq_cst
+        ) {
+            storage_.store(cipher::encrypt(val), order);
         }
 
-        OBFUSCXX_FORCEINLINE bool operator==(const obfuscxx& rhs) const
-            requires is_single
-        {
-            return get() == rhs.get();
+        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE Type exchange(
+            Type val, std::memory_order order = std::memory_order_seq_cst
+        ) {
+            return cipher::decrypt(storage_.exchange(cipher::encrypt(val), order));
         }
 
-        OBFUSCXX_FORCEINLINE bool operator==(const obfuscxx& rhs) const
-            requires is_array
-        {
-            for (std::size_t i{}; i < Size; ++i) {
-                if (get(i) != rhs.get(i)) {
-                    return false;
-                }
+        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE bool compare_exchange_strong(
+            Type& expected,
+            Type desired,
+            std::memory_order success = std::memory_order_seq_cst,
+            std::memory_order failure = std::memory_order_seq_cst
+        ) {
+            std::uint64_t block = cipher::encrypt(expected);
+            if (storage_.compare_exchange_strong(block, cipher::encrypt(desired), success, failure)) {
+                return true;
             }
-            return true;
+            expected = cipher::decrypt(block);
+            return false;
         }
 
-        OBFUSCXX_FORCEINLINE bool operator!=(const obfuscxx& rhs) const {
-            return !(*this == rhs);
+        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE bool compare_exchange_weak(
+            Type& expected,
+            Type desired,
+            std::memory_order success = std::memory_order_seq_cst,
+            std::memory_order failure = std::memory_order_seq_cst
+        ) {
+            std::uint64_t block = cipher::encrypt(expected);
+            if (storage_.compare_exchange_weak(block, cipher::encrypt(desired), success, failure)) {
+                return true;
+            }
+            expected = cipher::decrypt(block);
+            return false;
         }
 
-        OBFUSCXX_FORCEINLINE operator Type() const
-            requires is_single
-        {
-            return get();
+        OBFUSCXX_FORCEINLINE bool is_lock_free() const {
+            return storage_.is_lock_free();
         }
 
-        OBFUSCXX_FORCEINLINE bool operator<(const obfuscxx& rhs) const {
-            return get() < rhs.get();
+        OBFUSCXX_FORCEINLINE operator Type() const {
+            return load();
         }
 
-        OBFUSCXX_FORCEINLINE bool operator>(const obfuscxx& rhs) const {
-            return get() > rhs.get();
+    private:
+        std::atomic<std::uint64_t> storage_;
+    };
+
+    // Obfuscated array guarded by a sequence counter. Readers never lock: they copy the storage groups covering the
+    // requested range with relaxed atomic loads into a fixed window of chunk_blocks blocks, decrypt it with the regular
+    // kernels and retry if a writer ran meanwhile, so reads scale with the number of cores. Writers serialize on the
+    // counter (odd while a write is in progress) and re-encrypt only the blocks they change, publishing them with
+    // relaxed atomic stores. Every shared access is atomic, so there is no data race; a reader may still copy a
+    // half-written range, but its result is discarded before it is returned. Stack use does not depend on Size.
+    template<
+        class Type,
+        std::size_t Size,
+        obf_level Level = obf_level::Low,
+        std::uint64_t Entropy = OBFUSCXX_ENTROPY,
+        class Cipher = default_cipher>
+    class obfuscxx_seqlock {
+        using value_type = obfuscxx<Type, Size, Level, Entropy, Cipher>;
+        static_assert(Size > 1, "obfuscxx_seqlock holds arrays; use obfuscxx_atomic for single values");
+
+        static constexpr std::size_t words_per_element = value_type::words_per_element;
+        static constexpr std::size_t elements_per_block = value_type::elements_per_block;
+        static constexpr std::size_t group_blocks = value_type::storage_multiple;
+        // Blocks decrypted or encrypted per window; a multiple of every group size.
+        static constexpr std::size_t chunk_blocks = 64;
+        static constexpr std::size_t chunk_elements =
+            words_per_element > chunk_blocks ? 1 : chunk_blocks * elements_per_block / words_per_element;
+        // A read chunk may start and end inside a group; the window widens it to whole groups at both ends.
+        static constexpr std::size_t window_blocks =
+            ((chunk_elements * words_per_element) + elements_per_block - 1) / elements_per_block + (2 * group_blocks);
+
+    public:
+        explicit consteval obfuscxx_seqlock(
+            const Type (&arr)[Size], detail::site_location site = detail::site_location::current()
+        )
+            : value_(arr, site) {}
+
+        consteval obfuscxx_seqlock(
+            const std::initializer_list<Type>& list, detail::site_location site = detail::site_location::current()
+        )
+            : value_(list, site) {}
+
+        obfuscxx_seqlock(const obfuscxx_seqlock&) = delete;
+        obfuscxx_seqlock& operator=(const obfuscxx_seqlock&) = delete;
+
+        OBFUSCXX_FORCEINLINE Type get(std::size_t i) const {
+            for (;;) {
+                std::uint32_t const sequence = read_begin();
+                Type const val = load(i);
+                if (read_retry(sequence)) {
+                    continue;
+                }
+                return val;
+            }
         }
 
-        OBFUSCXX_FORCEINLINE bool operator<=(const obfuscxx& rhs) const {
-            return get() <= rhs.get();
+        OBFUSCXX_FORCEINLINE Type operator[](std::size_t i) const {
+            return get(i);
         }
 
-        OBFUSCXX_FORCEINLINE bool operator>=(const obfuscxx& rhs) const {
-            return get() >= rhs.get();
+        OBFUSCXX_FORCEINLINE void copy_to(Type* out, std::size_t count) const {
+            copy_to(out, 0, count);
         }
 
-        OBFUSCXX_FORCEINLINE Type operator+(const obfuscxx& rhs) const {
-            return get() + rhs.get();
+        // Consistent snapshot of elements [offset, offset + count); out is rewritten on every retry.
+        OBFUSCXX_FORCEINLINE void copy_to(Type* out, std::size_t offset, std::size_t count) const {
+            if (offset >= Size) {
+                return;
+            }
+            count = (count < Size - offset) ? count : Size - offset;
+            value_.profile_hit();
+            for (;;) {
+                std::uint32_t const sequence = read_begin();
+                read_range(out, offset, count);
+                if (!read_retry(sequence)) {
+                    return;
+                }
+            }
         }
 
-        OBFUSCXX_FORCEINLINE Type operator-(const obfuscxx& rhs) const {
-            return get() - rhs.get();
+        OBFUSCXX_RUNTIME_WARNING OBFUSCXX_FORCEINLINE void set(Type val, std::size_t i) {
+            std::uint32_t const sequence = write_begin();
+            if constexpr (value_type::is_wide) {
+                typename value_type::word_image const image = value_type::to_words(val);
+                for (std::size_t j{}; j < words_per_element; ++j) {
+                    std::size_t const index = (i * words_per_element) + j;
+                    store_block(index, value_type::encrypt_block(image.words[j], index));
+                }
+            } else {
+                std::size_t const index = i / elements_per_block;
+                std::uint64_t const block = value_type::decrypt_block(load_block(index), index);
+                std::uint64_t const next = value_type::insert(block, val, i % elements_per_block);
+                store_block(index, value_type::encrypt_block(next, index));
+            }
+            write_end(sequence);
         }
 
-        OBFUSCXX_FORCEINLINE Type operator*(const obfuscxx& rhs) const
-            requires(!is_single_pointer)
-        {
-            return get() * rhs.get();
+        OBFUSCXX_FORCEINLINE void assign(const Type* values, std::size_t count) {
+            count = (count < Size) ? count : Size;
+            std::uint32_t const sequence = write_begin();
+            for (std::size_t done{}; done < count; done += chunk_elements) {
+                write_range(values + done, done, (count - done < chunk_elements) ? count - done : chunk_elements);
+            }
+            write_end(sequence);
         }
 
-        OBFUSCXX_FORCEINLINE Type operator/(const obfuscxx& rhs) const
-            requires(!is_single_pointer)
-        {
-            return get() / rhs.get();
+        // Number of completed writes; stable while no writer is active.
+        OBFUSCXX_FORCEINLINE std::uint32_t version() const {
+            return sequence_.load(std::memory_order_acquire) >> 1;
         }
 
-        OBFUSCXX_FORCEINLINE obfuscxx& operator+=(const obfuscxx& rhs)
-            requires(!is_single_pointer)
-        {
-            set(get() + rhs.get());
-            return *this;
+        static constexpr std::size_t size() {
+            return Size;
         }
 
-        OBFUSCXX_FORCEINLINE obfuscxx& operator-=(const obfuscxx& rhs)
-            requires(!is_single_pointer)
-        {
-            set(get() - rhs.get());
-            return *this;
+    private:
+        OBFUSCXX_FORCEINLINE std::uint64_t load_block(std::size_t index) const {
+            return value_type::load_relaxed(value_.storage_[index]);
         }
 
-        OBFUSCXX_FORCEINLINE Type operator->()
-            requires is_single_pointer
-        {
-            return get();
+        // Publishes a block with a relaxed atomic store; the sequence counter orders it for readers.
+        OBFUSCXX_FORCEINLINE void store_block(std::size_t index, std::uint64_t block) {
+            std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(value_.storage_[index]))
+                .store(block, std::memory_order_relaxed);
         }
 
-        OBFUSCXX_FORCEINLINE Type& operator*()
-            requires is_single_pointer
-        {
-            return *get();
+        // Narrow elements are read from their single block; wide ones span several and go through a window.
+        OBFUSCXX_FORCEINLINE Type load(std::size_t i) const {
+            value_.profile_hit();
+            if constexpr (value_type::is_wide) {
+                Type val;
+                read_range(&val, i, 1);
+                return val;
+            } else {
+                std::size_t const block = i / elements_per_block;
+                return value_type::extract(value_type::decrypt_block(load_block(block), block), i % elements_per_block);
+            }
         }
 
-        struct iterator {
-            const obfuscxx* parent;
-            std::size_t index;
+        // Decrypts elements [offset, offset + count) chunk by chunk. Each chunk copies only the groups covering it.
+        OBFUSCXX_FORCEINLINE void read_range(Type* out, std::size_t offset, std::size_t count) const {
+            for (std::size_t done{}; done < count; done += chunk_elements) {
+                std::size_t const n = (count - done < chunk_elements) ? count - done : chunk_elements;
+                std::size_t const first = (offset + done) * words_per_element;
+                std::size_t const last = first + (n * words_per_element);
+                std::size_t const begin_block = (first / elements_per_block) & ~(group_blocks - 1);
+                std::size_t const end_block =
+                    ((last + elements_per_block - 1) / elements_per_block + group_blocks - 1) & ~(group_blocks - 1);
 
-            Type operator*() const {
-                return parent->get(index);
+                alignas(value_type::storage_alignment) std::uint64_t window[window_blocks];
+                for (std::size_t b = begin_block; b < end_block; ++b) {
+                    window[b - begin_block] = load_block(b);
+                }
+                detail::block_window<const volatile std::uint64_t> const blocks{window, begin_block};
+                if constexpr (value_type::is_wide) {
+                    std::uint64_t words[chunk_elements * words_per_element];
+                    value_type::decrypt_vectorized(blocks, words, first, last - first);
+                    for (std::size_t k{}; k < n; ++k) {
+                        out[done + k] = value_type::from_words(words + (k * words_per_element));
+                    }
+                } else {
+                    value_type::decrypt_vectorized(blocks, out + done, first, last - first);
+                }
             }
+        }
 
-            iterator& operator++() {
-                ++index;
-                return *this;
+        // Encrypts elements [offset, offset + count) of one chunk; offset is a multiple of chunk_elements, so the
+        // chunk starts on a group boundary. Whole blocks go through the vector encryptor, a partial last block is
+        // merged with the elements already stored in it.
+        OBFUSCXX_FORCEINLINE void write_range(const Type* values, std::size_t offset, std::size_t count) {
+            if constexpr (value_type::is_wide) {
+                for (std::size_t k{}; k < count; ++k) {
+                    typename value_type::word_image const image = value_type::to_words(values[k]);
+                    for (std::size_t j{}; j < words_per_element; ++j) {
+                        std::size_t const index = ((offset + k) * words_per_element) + j;
+                        store_block(index, value_type::encrypt_block(image.words[j], index));
+                    }
+                }
+            } else {
+                std::size_t const begin_block = offset / elements_per_block;
+                std::size_t const whole = count / elements_per_block;
+                alignas(value_type::storage_alignment) std::uint64_t window[chunk_blocks];
+                detail::block_window<volatile std::uint64_t> const blocks{window, begin_block};
+
+                std::size_t b = begin_block + value_type::encrypt_vectorized(blocks, values, begin_block, whole);
+                for (; b < begin_block + whole; ++b) {
+                    std::size_t const k = (b - begin_block) * elements_per_block;
+                    blocks[b] = value_type::encrypt_block(value_type::pack(0, values + k, elements_per_block), b);
+                }
+                if (std::size_t const rest = count % elements_per_block; rest != 0) {
+                    std::size_t const k = whole * elements_per_block;
+                    std::uint64_t const block = value_type::decrypt_block(load_block(b), b);
+                    blocks[b] = value_type::encrypt_block(value_type::pack(block, values + k, rest), b);
+                    ++b;
+                }
+                for (std::size_t i = begin_block; i < b; ++i) {
+                    store_block(i, blocks[i]);
+                }
             }
+        }
 
-            bool operator!=(const iterator& other) const {
-                return index != other.index;
-            }
-            bool operator==(const iterator& other) const {
-                return index == other.index;
+        OBFUSCXX_FORCEINLINE std::uint32_t read_begin() const {
+            std::uint32_t sequence = sequence_.load(std::memory_order_acquire);
+            while ((sequence & 1) != 0) {
+                detail::cpu_relax();
+                sequence = sequence_.load(std::memory_order_acquire);
             }
-        };
+            return sequence;
+        }
 
-        iterator begin() const
-            requires is_array
-        {
-            return {this, 0};
+        OBFUSCXX_FORCEINLINE bool read_retry(std::uint32_t sequence) const {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return sequence_.load(std::memory_order_relaxed) != sequence;
         }
-        iterator end() const
-            requires is_array
-        {
-            return {this, Size};
+
+        OBFUSCXX_FORCEINLINE std::uint32_t write_begin() {
+            std::uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+            for (;;) {
+                if ((sequence & 1) != 0) {
+                    detail::cpu_relax();
+                    sequence = sequence_.load(std::memory_order_relaxed);
+                } else if (sequence_.compare_exchange_weak(
+                               sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed
+                           )) {
+                    break;
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            return sequence + 1;
         }
-        static constexpr std::size_t size() {
-            return Size;
+
+        OBFUSCXX_FORCEINLINE void write_end(std::uint32_t sequence) {
+            sequence_.store(sequence + 1, std::memory_order_release);
         }
 
-        template<class CharType, std::size_t N> struct string_copy {
-        private:
-            static constexpr bool is_char = std::is_same_v<CharType, char> || std::is_same_v<CharType, const char>;
-            static constexpr bool is_wchar =
-                std::is_same_v<CharType, wchar_t> || std::is_same_v<CharType, const wchar_t>;
+        alignas(64) std::atomic<std::uint32_t> sequence_{};
+        value_type value_;
+    };
+#endif
 
-        public:
-            operator const char*() const
-                requires is_char
-            {
-                return data;
-            }
-            operator const wchar_t*() const
-                requires is_wchar
-            {
-                return data;
-            }
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+    namespace detail {
+        // Wide types span several blocks and cannot share a lane, so they take the one-by-one path.
+        template<class Obj> struct is_xtea_instance : std::false_type {};
+        template<class Type, std::size_t Size, obf_level Level, std::uint64_t Entropy>
+        struct is_xtea_instance<obfuscxx<Type, Size, Level, Entropy, xtea>> : std::bool_constant<sizeof(Type) <= 8> {};
+
+        // Decrypts independent single-value XTEA instances side by side, one per 32-bit lane of a 128-bit vector. Every
+        // lane carries its own round keys. Instances with fewer rounds than the slowest one are masked off until their
+        // first round, so all lanes finish together.
+        template<class... Objs> struct batch_decryptor {
+#if defined(__aarch64__) || defined(_M_ARM64)
+            using vec = uint32x4_t;
+#else
+            using vec = __m128i;
+#endif
+            static constexpr std::size_t lanes = 4;
 
-            const CharType* c_str() const {
-                return data;
-            }
-            const CharType& operator[](std::size_t i) const {
-                return data[i];
-            }
+            static_assert((Objs::is_single && ...), "decrypt_all() only accepts single-value obfuscxx instances");
 
-            const CharType* begin() const {
-                return data;
-            }
-            const CharType* end() const {
-                return data + N;
+            static constexpr std::size_t count = sizeof...(Objs);
+            static constexpr std::size_t groups = (count + lanes - 1) / lanes;
+            static constexpr std::size_t width = groups * lanes;
+            static constexpr std::uint32_t rounds = [] {
+                std::uint32_t result{};
+                ((result = Objs::engine::rounds > result ? Objs::engine::rounds : result), ...);
+                return result;
+            }();
+            static constexpr bool uniform = ((Objs::engine::rounds == rounds) && ...);
+
+            struct schedule_t {
+                alignas(16) std::uint32_t keys[rounds * 2][width];
+                alignas(16) std::uint32_t masks[rounds * 2][width];
+            };
+
+            template<class Obj> static constexpr void fill_lane(schedule_t& schedule, std::size_t lane) {
+                std::uint32_t const offset = (rounds - Obj::engine::rounds) * 2;
+                for (std::uint32_t step = offset; step < rounds * 2; ++step) {
+                    schedule.keys[step][lane] = Obj::engine::decrypt_round_key(step - offset);
+                    schedule.masks[step][lane] = 0xFFFFFFFF;
+                }
             }
 
-            constexpr std::size_t size() const {
-                return N;
+            static constexpr schedule_t schedule = [] {
+                schedule_t result{};
+                std::size_t lane{};
+                (fill_lane<Objs>(result, lane++), ...);
+                return result;
+            }();
+
+            template<typename Vec>
+            static OBFUSCXX_FORCEINLINE void half_round(const Vec& va, Vec& vb, std::uint32_t step, std::size_t group) {
+                using S = simd<Vec>;
+                Vec temp = S::vadd(S::vxor(S::shl4(va), S::shr5(va)), va);
+                temp = S::vxor(temp, S::load(&schedule.keys[step][group * lanes]));
+                if constexpr (!uniform) {
+                    temp = S::vand(temp, S::load(&schedule.masks[step][group * lanes]));
+                }
+                vb = S::vsub(vb, temp);
             }
 
-            CharType data[N];
-        };
+            template<typename Vec = vec> static OBFUSCXX_FORCEINLINE auto decrypt(const Objs&... objs) {
+                using S = simd<Vec>;
+                alignas(16) std::uint64_t blocks[width]{};
+                (objs.profile_hit(), ...);
+                (Objs::trace(detail::trace_event::vector_decrypt, 1), ...);
+                std::size_t lane{};
+                ((blocks[lane++] = *static_cast<volatile const std::uint64_t*>(&objs.storage_[0])), ...);
+
+                Vec v0[groups];
+                Vec v1[groups];
+                for (std::size_t g{}; g < groups; ++g) {
+                    S::load_blocks(&blocks[g * lanes], v0[g], v1[g]);
+                }
 
-        template<class ArrayType, std::size_t N> struct array_copy {
-            const ArrayType* get() const {
-                return data;
-            }
+                for (std::uint32_t step{}; step < rounds * 2; step += 2) {
+                    for (std::size_t g{}; g < groups; ++g) {
+                        OBFUSCXX_MEM_BARRIER_VEC(v0[g], v1[g], step)
+                        half_round(v0[g], v1[g], step, g);
+                        OBFUSCXX_MEM_BARRIER_VEC(v0[g], v1[g], step)
+                        half_round(v1[g], v0[g], step + 1, g);
+                    }
+                }
 
-            const ArrayType* begin() const {
-                return data;
-            }
-            const ArrayType* end() const {
-                return data + N;
-            }
+                for (std::size_t g{}; g < groups; ++g) {
+                    S::store_blocks(&blocks[g * lanes], v0[g], v1[g]);
+                }
 
-            constexpr std::size_t size() const {
-                return N;
+                return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return std::tuple<decltype(objs.get())...>(Objs::from_uint64(blocks[I])...);
+                }(std::index_sequence_for<Objs...>{});
             }
-            constexpr std::size_t size_bytes() const {
-                return N * sizeof(ArrayType);
+        };
+    } // namespace detail
+
+    // Decrypts several single-value instances in one SIMD pass and returns their values as a tuple, e.g.
+    // auto [width, height, scale] = ngu::decrypt_all(cfg_width, cfg_height, cfg_scale);
+    // The batched pass covers XTEA instances; with any other cipher the values are decrypted one by one.
+    template<class... Objs> OBFUSCXX_FORCEINLINE auto decrypt_all(const Objs&... objs)
+        requires(sizeof...(Objs) != 0)
+    {
+        if constexpr ((detail::is_xtea_instance<Objs>::value && ...)) {
+            return detail::batch_decryptor<Objs...>::decrypt(objs...);
+        } else {
+            return std::tuple<decltype(objs.get())...>(objs.get()...);
+        }
+    }
+#endif
+
+// Content keys are a function of the literal and this seed alone. A library-wide default would encrypt a given literal
+// identically in every program built with obfuscxx, so the seed has to come from the project.
+#if defined(OBFUSCXX_ENTROPY_SEED)
+#define OBFUSCXX_CONTENT_SEED ((std::uint64_t)(OBFUSCXX_ENTROPY_SEED))
+#elif defined(OBFUSCXX_DEDUP_LITERALS)
+#error "OBFUSCXX_DEDUP_LITERALS requires a project-specific OBFUSCXX_ENTROPY_SEED"
+#endif
+
+    namespace detail {
+        // String literal usable as a template argument, so equal literals name the same specialization in every
+        // translation unit.
+        template<class CharType, std::size_t N> struct literal {
+            using char_type = CharType;
+            static constexpr std::size_t size = N;
+
+            consteval literal(const CharType (&str)[N]) {
+                for (std::size_t i{}; i < N; ++i) {
+                    data[i] = str[i];
+                }
             }
 
-            ArrayType data[N];
+            CharType data[N];
         };
 
-        OBFUSCXX_FORCEINLINE string_copy<Type, Size> to_string() const
-            requires(is_char || is_wchar)
-        {
-            string_copy<Type, Size> result{};
-            if constexpr (is_array) {
-                copy_to(result.data, Size);
-            } else {
-                result.data[0] = get();
+        // Entropy taken from the characters alone. OBFUSCXX_ENTROPY mixes in __FILE__, __LINE__, __COUNTER__ and
+        // __TIME__, all of which differ between the places a literal is used.
+        template<class CharType, std::size_t N>
+        consteval std::uint64_t content_entropy(const CharType (&data)[N]) {
+#if !defined(OBFUSCXX_CONTENT_SEED)
+            static_assert(sizeof(CharType) == 0, "shared_literal requires a project-specific OBFUSCXX_ENTROPY_SEED");
+            return 0;
+#else
+            std::uint64_t hash = splitmix64(OBFUSCXX_CONTENT_SEED ^ (N * sizeof(CharType)));
+            for (std::size_t i{}; i < N; ++i) {
+                auto const unit = static_cast<std::make_unsigned_t<CharType>>(data[i]);
+                hash = splitmix64(hash ^ static_cast<std::uint64_t>(unit));
             }
-            return result;
+            return hash;
+#endif
         }
+    } // namespace detail
 
-        OBFUSCXX_FORCEINLINE array_copy<Type, Size> to_array() const
-            requires(is_array)
-        {
-            array_copy<Type, Size> result{};
-            copy_to(result.data, Size);
-            return result;
+    // One encrypted copy per distinct literal and level in the whole program. The variable template has vague linkage,
+    // so the linker folds the copies emitted by different translation units: ngu::shared_literal<"name">.to_string().
+    template<detail::literal Str, obf_level Level = obf_level::Low>
+    inline obfuscxx<typename decltype(Str)::char_type, decltype(Str)::size, Level, detail::content_entropy(Str.data)>
+        shared_literal{Str.data};
+
+    namespace detail {
+        // Out-of-line accessors behind the OBFUSCXX_DEDUP_LITERALS macros, so every use of a literal calls one decrypt
+        // sequence instead of inlining its own.
+        template<literal Str, obf_level Level = obf_level::Low> OBFUSCXX_NOINLINE auto shared_string() {
+            return shared_literal<Str, Level>.to_string();
         }
 
-    private:
-        alignas(storage_alignment) OBFUSCXX_VOLATILE std::uint64_t storage_[storage_size]{};
-    };
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+        template<literal Str, obf_level Level = obf_level::Low> OBFUSCXX_NOINLINE auto shared_string_view() {
+            return shared_literal<Str, Level>.to_string_view();
+        }
+#endif
+    } // namespace detail
 } // namespace ngu
 
-#if defined(__clang__) || defined(__GNUC__)
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+template<class Type, std::size_t Size, ngu::obf_level Level, std::uint64_t Entropy, class Cipher>
+    requires requires(const ngu::obfuscxx<Type, Size, Level, Entropy, Cipher>& value) { value.ciphertext_hash(); }
+struct std::hash<ngu::obfuscxx<Type, Size, Level, Entropy, Cipher>> {
+    std::size_t operator()(const ngu::obfuscxx<Type, Size, Level, Entropy, Cipher>& value) const {
+        return value.ciphertext_hash();
+    }
+};
+#endif
+
+#if OBFUSCXX_HAS_DISPATCH
+#pragma GCC diagnostic pop
+#endif
+
+// OBFUSCXX_DEDUP_LITERALS keys string literals by their contents rather than by where they appear, so a literal used
+// in many places is stored and decrypted by a single shared instance.
+#if defined(OBFUSCXX_DEDUP_LITERALS)
+template<ngu::detail::literal Str> auto operator""_obf() {
+    return ngu::detail::shared_string<Str>();
+}
+#elif defined(__clang__) || defined(__GNUC__)
 template<typename CharType, CharType... Chars> constexpr auto operator""_obf() {
     constexpr CharType str[] = {Chars..., '\0'};
     return ngu::obfuscxx(str).to_string();
@@ -858,6 +3581,17 @@ template<typename CharType, CharType... Chars> constexpr auto operator""_obf() {
 #endif
 
 #define obfusv(val) ngu::obfuscxx(val).get()
+#if defined(OBFUSCXX_DEDUP_LITERALS)
+#define obfuss(str) ngu::detail::shared_string<str>().c_str()
+#else
 #define obfuss(str) ngu::obfuscxx(str).to_string().c_str()
+#endif
+#if !defined(_KERNEL_MODE) && !defined(_WIN64_DRIVER)
+#if defined(OBFUSCXX_DEDUP_LITERALS)
+#define obfussv(str) ngu::detail::shared_string_view<str>()
+#else
+#define obfussv(str) ngu::obfuscxx(str).to_string_view()
+#endif
+#endif
 
 #endif // NGU_OBFUSCXX_H
\ No newline at end of file
@@ -18,6 +18,14 @@
 #ifndef NGU_OBFUSCXX_METRICS_BENCHMARK_H
 #define NGU_OBFUSCXX_METRICS_BENCHMARK_H
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <benchmark/benchmark.h>
 #include <obfuscxx/obfuscxx.h>
 
@@ -71,6 +79,132 @@ static void BM_FloatGet_High(benchmark::State& state) {
 }
 BENCHMARK(BM_FloatGet_High);
 
+static void BM_FourIntegerGet_Low(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::Low> a{1};
+    obfuscxx<int, 1, obf_level::Low> b{2};
+    obfuscxx<int, 1, obf_level::Low> c{3};
+    obfuscxx<int, 1, obf_level::Low> d{4};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.get());
+        benchmark::DoNotOptimize(b.get());
+        benchmark::DoNotOptimize(c.get());
+        benchmark::DoNotOptimize(d.get());
+    }
+}
+BENCHMARK(BM_FourIntegerGet_Low);
+
+static void BM_DecryptAll_Low(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::Low> a{1};
+    obfuscxx<int, 1, obf_level::Low> b{2};
+    obfuscxx<int, 1, obf_level::Low> c{3};
+    obfuscxx<int, 1, obf_level::Low> d{4};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decrypt_all(a, b, c, d));
+    }
+}
+BENCHMARK(BM_DecryptAll_Low);
+
+static void BM_FourIntegerGet_Medium(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::Medium> a{1};
+    obfuscxx<int, 1, obf_level::Medium> b{2};
+    obfuscxx<int, 1, obf_level::Medium> c{3};
+    obfuscxx<int, 1, obf_level::Medium> d{4};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.get());
+        benchmark::DoNotOptimize(b.get());
+        benchmark::DoNotOptimize(c.get());
+        benchmark::DoNotOptimize(d.get());
+    }
+}
+BENCHMARK(BM_FourIntegerGet_Medium);
+
+static void BM_DecryptAll_Medium(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::Medium> a{1};
+    obfuscxx<int, 1, obf_level::Medium> b{2};
+    obfuscxx<int, 1, obf_level::Medium> c{3};
+    obfuscxx<int, 1, obf_level::Medium> d{4};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decrypt_all(a, b, c, d));
+    }
+}
+BENCHMARK(BM_DecryptAll_Medium);
+
+static void BM_FourIntegerGet_High(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::High> a{1};
+    obfuscxx<int, 1, obf_level::High> b{2};
+    obfuscxx<int, 1, obf_level::High> c{3};
+    obfuscxx<int, 1, obf_level::High> d{4};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.get());
+        benchmark::DoNotOptimize(b.get());
+        benchmark::DoNotOptimize(c.get());
+        benchmark::DoNotOptimize(d.get());
+    }
+}
+BENCHMARK(BM_FourIntegerGet_High);
+
+static void BM_DecryptAll_High(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::High> a{1};
+    obfuscxx<int, 1, obf_level::High> b{2};
+    obfuscxx<int, 1, obf_level::High> c{3};
+    obfuscxx<int, 1, obf_level::High> d{4};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decrypt_all(a, b, c, d));
+    }
+}
+BENCHMARK(BM_DecryptAll_High);
+
+// A 256-bit key held as four single-value instances, each decrypted on its own, against one wide instance whose four
+// words are decrypted in a single vector pass.
+struct key256 {
+    std::uint64_t words[4];
+};
+
+template<obf_level Level> static void BM_KeySplitGet(benchmark::State& state) {
+    obfuscxx<std::uint64_t, 1, Level> a{1};
+    obfuscxx<std::uint64_t, 1, Level> b{2};
+    obfuscxx<std::uint64_t, 1, Level> c{3};
+    obfuscxx<std::uint64_t, 1, Level> d{4};
+    for (auto _ : state) {
+        key256 key{{a.get(), b.get(), c.get(), d.get()}};
+        benchmark::DoNotOptimize(key);
+    }
+}
+BENCHMARK(BM_KeySplitGet<obf_level::Medium>);
+BENCHMARK(BM_KeySplitGet<obf_level::High>);
+
+template<obf_level Level> static void BM_KeyWideGet(benchmark::State& state) {
+    obfuscxx<key256, 1, Level> key{key256{{1, 2, 3, 4}}};
+    for (auto _ : state) {
+        key256 value = key.get();
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_KeyWideGet<obf_level::Medium>);
+BENCHMARK(BM_KeyWideGet<obf_level::High>);
+
+// 512 distinct High instances read back to back. With the default policy every read inlines its own round loop, so
+// one pass walks far more code than the L1 instruction cache holds; the outlined policy runs every read through one
+// shared kernel. The benchmark target reports the INSTRUCTIONS and L1-ICACHE-LOAD-MISSES counters per iteration
+// (OBFUSCXX_BENCHMARK_PERF_COUNTERS) where the host exposes them.
+constexpr std::size_t many_sites = 512;
+
+template<class Cipher, std::size_t I>
+inline obfuscxx<int, 1, obf_level::High, 0x5eed0000 + I, Cipher> site_value{static_cast<int>(I)};
+
+template<class Cipher, std::size_t... I> static int read_sites(std::index_sequence<I...>) {
+    return (site_value<Cipher, I>.get() + ...);
+}
+
+template<class Cipher> static void BM_ManySites_High(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(read_sites<Cipher>(std::make_index_sequence<many_sites>{}));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * many_sites));
+}
+BENCHMARK(BM_ManySites_High<xtea>);
+BENCHMARK(BM_ManySites_High<outlined>);
+
 static void BM_StringGet_Low(benchmark::State& state) {
     obfuscxx<char, 10, obf_level::Low> str("benchmark");
     for (auto _ : state) {
@@ -119,6 +253,31 @@ static void BM_WStringGet_High(benchmark::State& state) {
 }
 BENCHMARK(BM_WStringGet_High);
 
+// A 512-character string decrypted into a stack copy, against a view into the thread's plaintext arena that is
+// wiped when the scope closes.
+static void BM_LongStringGet_Medium(benchmark::State& state) {
+    std::array<char, 512> text{};
+    std::fill(text.begin(), text.end() - 1, 'x');
+    obfuscxx<char, 512, obf_level::Medium> str{};
+    str.assign(text.data(), text.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(str.to_string().c_str());
+    }
+}
+BENCHMARK(BM_LongStringGet_Medium);
+
+static void BM_LongStringView_Medium(benchmark::State& state) {
+    std::array<char, 512> text{};
+    std::fill(text.begin(), text.end() - 1, 'x');
+    obfuscxx<char, 512, obf_level::Medium> str{};
+    str.assign(text.data(), text.size());
+    for (auto _ : state) {
+        plaintext_scope scope;
+        benchmark::DoNotOptimize(str.to_string_view().data());
+    }
+}
+BENCHMARK(BM_LongStringView_Medium);
+
 static void BM_ArrayIteration_Low(benchmark::State& state) {
     obfuscxx<int, 100, obf_level::Low> array{};
     for (auto _ : state) {
@@ -179,6 +338,186 @@ static void BM_ArrayCopyTo_High(benchmark::State& state) {
 }
 BENCHMARK(BM_ArrayCopyTo_High);
 
+static void BM_IntegerGet_Low_Speck(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::Low, OBFUSCXX_ENTROPY, speck> int_value{42};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(int_value.get());
+    }
+}
+BENCHMARK(BM_IntegerGet_Low_Speck);
+
+static void BM_IntegerGet_Medium_Speck(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::Medium, OBFUSCXX_ENTROPY, speck> int_value{42};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(int_value.get());
+    }
+}
+BENCHMARK(BM_IntegerGet_Medium_Speck);
+
+static void BM_IntegerGet_High_Speck(benchmark::State& state) {
+    obfuscxx<int, 1, obf_level::High, OBFUSCXX_ENTROPY, speck> int_value{42};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(int_value.get());
+    }
+}
+BENCHMARK(BM_IntegerGet_High_Speck);
+
+static void BM_ArrayCopyTo_Low_Speck(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Low, OBFUSCXX_ENTROPY, speck> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.to_array());
+    }
+}
+BENCHMARK(BM_ArrayCopyTo_Low_Speck);
+
+static void BM_ArrayCopyTo_Medium_Speck(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Medium, OBFUSCXX_ENTROPY, speck> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.to_array());
+    }
+}
+BENCHMARK(BM_ArrayCopyTo_Medium_Speck);
+
+static void BM_ArrayCopyTo_High_Speck(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::High, OBFUSCXX_ENTROPY, speck> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.to_array());
+    }
+}
+BENCHMARK(BM_ArrayCopyTo_High_Speck);
+
+static void BM_ArrayCopyTo_Low_Ctr(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Low, OBFUSCXX_ENTROPY, ctr<>> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.to_array());
+    }
+}
+BENCHMARK(BM_ArrayCopyTo_Low_Ctr);
+
+static void BM_ArrayCopyTo_Medium_Ctr(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Medium, OBFUSCXX_ENTROPY, ctr<>> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.to_array());
+    }
+}
+BENCHMARK(BM_ArrayCopyTo_Medium_Ctr);
+
+static void BM_ArrayCopyTo_High_Ctr(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::High, OBFUSCXX_ENTROPY, ctr<>> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.to_array());
+    }
+}
+BENCHMARK(BM_ArrayCopyTo_High_Ctr);
+
+// A 16 KiB table in both modes. Both are bound by the cipher rounds, so counter mode reads at the same speed as the
+// default; what it buys is position-dependent ciphertext.
+template<class Cipher> static void BM_TableCopyTo_Medium(benchmark::State& state) {
+    static obfuscxx<int, 4096, obf_level::Medium, OBFUSCXX_ENTROPY, Cipher> table{};
+    static std::array<int, 4096> out{};
+    for (auto _ : state) {
+        table.copy_to(out.data(), out.size());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * sizeof(out));
+}
+BENCHMARK(BM_TableCopyTo_Medium<xtea>);
+BENCHMARK(BM_TableCopyTo_Medium<ctr<>>);
+
+static void BM_ArraySlice_Low(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Low> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.decrypt_range<16>(37));
+    }
+}
+BENCHMARK(BM_ArraySlice_Low);
+
+static void BM_ArraySlice_Medium(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Medium> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.decrypt_range<16>(37));
+    }
+}
+BENCHMARK(BM_ArraySlice_Medium);
+
+static void BM_ArraySlice_High(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::High> array{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(array.decrypt_range<16>(37));
+    }
+}
+BENCHMARK(BM_ArraySlice_High);
+
+static void BM_ArrayAssign_Low(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Low> array{};
+    int values[100]{};
+    for (auto _ : state) {
+        array.assign(values, 100);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ArrayAssign_Low);
+
+static void BM_ArrayAssign_Medium(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::Medium> array{};
+    int values[100]{};
+    for (auto _ : state) {
+        array.assign(values, 100);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ArrayAssign_Medium);
+
+static void BM_ArrayAssign_High(benchmark::State& state) {
+    obfuscxx<int, 100, obf_level::High> array{};
+    int values[100]{};
+    for (auto _ : state) {
+        array.assign(values, 100);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ArrayAssign_High);
+
+static void BM_MapLookup_Low(benchmark::State& state) {
+    static constexpr obfuscxx_map<const char*, int, 4, obf_level::Low> map{{
+        {"http", 80},
+        {"https", 443},
+        {"ssh", 22},
+        {"dns", 53},
+    }};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.get("ssh"));
+    }
+}
+BENCHMARK(BM_MapLookup_Low);
+
+static void BM_MapLookup_Medium(benchmark::State& state) {
+    static constexpr obfuscxx_map<const char*, int, 4, obf_level::Medium> map{{
+        {"http", 80},
+        {"https", 443},
+        {"ssh", 22},
+        {"dns", 53},
+    }};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.get("ssh"));
+    }
+}
+BENCHMARK(BM_MapLookup_Medium);
+
+static void BM_MapLookup_High(benchmark::State& state) {
+    static constexpr obfuscxx_map<const char*, int, 4, obf_level::High> map{{
+        {"http", 80},
+        {"https", 443},
+        {"ssh", 22},
+        {"dns", 53},
+    }};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.get("ssh"));
+    }
+}
+BENCHMARK(BM_MapLookup_High);
+
 static void BM_ArrayGet_Low(benchmark::State& state) {
     obfuscxx<int, 100, obf_level::Low> array{};
     for (auto _ : state) {
@@ -203,4 +542,160 @@ static void BM_ArrayGet_High(benchmark::State& state) {
 }
 BENCHMARK(BM_ArrayGet_High);
 
+// Throughput families over Size and element type. Sizes up to 1M elements cannot go through the consteval
+// constructor, so the ciphertext is produced once at setup with the library's key schedule and read through
+// obfuscxx_blob, which decrypts with the same decrypt_vectorized() path as obfuscxx::copy_to(). Every shape has a
+// plain std::array baseline; compare bytes_per_second between BM_Throughput and BM_ThroughputPlain for the overhead.
+// OBFUSCXX_ENTROPY differs per expansion, so the key used at setup and the blob's key come from one constant.
+static constexpr std::uint64_t throughput_entropy = OBFUSCXX_ENTROPY;
+
+template<class Type, std::size_t Size> struct alignas(64) throughput_storage {
+    static constexpr std::size_t blocks = (((Size * sizeof(Type)) + 7) / 8 + 15) / 16 * 16;
+    std::uint64_t data[blocks];
+};
+
+template<class Type> static Type throughput_value(std::size_t i) {
+    return static_cast<Type>((i * 2654435761u) >> 7);
+}
+
+template<class Type, std::size_t Size, obf_level Level>
+static const throughput_storage<Type, Size>& throughput_cipher() {
+    static const auto storage = [] {
+        auto buffer = std::make_unique<throughput_storage<Type, Size>>();
+        std::vector<Type> plain(Size);
+        for (std::size_t i{}; i < Size; ++i) {
+            plain[i] = throughput_value<Type>(i);
+        }
+        // Elements narrower than a block are packed little-endian, which is their in-memory layout on x86/ARM64.
+        std::memset(buffer->data, 0, sizeof(buffer->data));
+        std::memcpy(buffer->data, plain.data(), Size * sizeof(Type));
+        auto const key = detail::make_xtea_key(throughput_entropy, Level);
+        for (std::size_t i{}; i < ((Size * sizeof(Type)) + 7) / 8; ++i) {
+            buffer->data[i] = detail::xtea_encrypt(key, buffer->data[i]);
+        }
+        return buffer;
+    }();
+    return *storage;
+}
+
+template<class Type, std::size_t Size> static const std::array<Type, Size>& throughput_plain() {
+    static const auto storage = [] {
+        auto buffer = std::make_unique<std::array<Type, Size>>();
+        for (std::size_t i{}; i < Size; ++i) {
+            (*buffer)[i] = throughput_value<Type>(i);
+        }
+        return buffer;
+    }();
+    return *storage;
+}
+
+static int throughput_threads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+template<class Type, std::size_t Size, obf_level Level> static void BM_Throughput(benchmark::State& state) {
+    obfuscxx_blob<Type, Size, Level, throughput_entropy> blob{throughput_cipher<Type, Size, Level>().data};
+    std::vector<Type> out(Size);
+    blob.copy_to(out.data(), Size);
+    if (!std::equal(out.begin(), out.end(), throughput_plain<Type, Size>().begin())) {
+        state.SkipWithError("decrypted data does not match the plaintext baseline");
+        return;
+    }
+    for (auto _ : state) {
+        blob.copy_to(out.data(), Size);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * Size * sizeof(Type)));
+}
+
+template<class Type, std::size_t Size> static void BM_ThroughputPlain(benchmark::State& state) {
+    const std::array<Type, Size>& source = throughput_plain<Type, Size>();
+    std::vector<Type> out(Size);
+    for (auto _ : state) {
+        std::copy(source.begin(), source.end(), out.begin());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * Size * sizeof(Type)));
+}
+
+#define OBFUSCXX_BENCHMARK_THROUGHPUT(Type, Size)                    \
+    BENCHMARK_TEMPLATE(BM_ThroughputPlain, Type, Size)               \
+        ->ThreadRange(1, throughput_threads())                       \
+        ->UseRealTime();                                             \
+    BENCHMARK_TEMPLATE(BM_Throughput, Type, Size, obf_level::Low)    \
+        ->ThreadRange(1, throughput_threads())                       \
+        ->UseRealTime();                                             \
+    BENCHMARK_TEMPLATE(BM_Throughput, Type, Size, obf_level::Medium) \
+        ->ThreadRange(1, throughput_threads())                       \
+        ->UseRealTime();                                             \
+    BENCHMARK_TEMPLATE(BM_Throughput, Type, Size, obf_level::High)   \
+        ->ThreadRange(1, throughput_threads())                       \
+        ->UseRealTime()
+
+OBFUSCXX_BENCHMARK_THROUGHPUT(std::uint8_t, 16);
+OBFUSCXX_BENCHMARK_THROUGHPUT(std::uint8_t, 1024);
+OBFUSCXX_BENCHMARK_THROUGHPUT(std::uint8_t, 65536);
+OBFUSCXX_BENCHMARK_THROUGHPUT(std::uint8_t, 1048576);
+OBFUSCXX_BENCHMARK_THROUGHPUT(int, 16);
+OBFUSCXX_BENCHMARK_THROUGHPUT(int, 1024);
+OBFUSCXX_BENCHMARK_THROUGHPUT(int, 65536);
+OBFUSCXX_BENCHMARK_THROUGHPUT(int, 1048576);
+OBFUSCXX_BENCHMARK_THROUGHPUT(double, 16);
+OBFUSCXX_BENCHMARK_THROUGHPUT(double, 1024);
+OBFUSCXX_BENCHMARK_THROUGHPUT(double, 65536);
+OBFUSCXX_BENCHMARK_THROUGHPUT(double, 1048576);
+
+// Shared instances read from every benchmark thread; neither path takes a lock, so time per read should stay flat.
+static void BM_AtomicLoad_Medium(benchmark::State& state) {
+    static obfuscxx_atomic<int, obf_level::Medium> value{42};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value.load(std::memory_order_acquire));
+    }
+}
+BENCHMARK(BM_AtomicLoad_Medium)->ThreadRange(1, throughput_threads())->UseRealTime();
+
+static void BM_SeqlockCopyTo_Medium(benchmark::State& state) {
+    static obfuscxx_seqlock<int, 1024, obf_level::Medium> table{0};
+    std::vector<int> out(table.size());
+    for (auto _ : state) {
+        table.copy_to(out.data(), out.size());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * out.size() * sizeof(int)));
+}
+BENCHMARK(BM_SeqlockCopyTo_Medium)->ThreadRange(1, throughput_threads())->UseRealTime();
+
+// Partial accesses copy and re-encrypt only the storage groups they touch, so they cost the same as on obfuscxx.
+static void BM_SeqlockSlice_Low(benchmark::State& state) {
+    static obfuscxx_seqlock<int, 4096, obf_level::Low> table{0};
+    int out[16];
+    for (auto _ : state) {
+        table.copy_to(out, 1000, 16);
+        benchmark::DoNotOptimize(out);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_SeqlockSlice_Low);
+
+// set() is deprecated to steer callers towards compile-time initialization; measuring it is the point here.
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+static void BM_SeqlockSet_Low(benchmark::State& state) {
+    static obfuscxx_seqlock<int, 4096, obf_level::Low> table{0};
+    int i{};
+    for (auto _ : state) {
+        table.set(i, static_cast<std::size_t>(i) & 4095);
+        ++i;
+    }
+}
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+BENCHMARK(BM_SeqlockSet_Low);
+
 #endif // NGU_OBFUSCXX_METRICS_BENCHMARK_H
\ No newline at end of file
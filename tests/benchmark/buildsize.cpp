@@ -0,0 +1,321 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2025-2026 nevergiveupcpp
+
+// Copyright 2025-2026 nevergiveupcpp
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compile-time and code-size benchmark. For every (Size, instance count) pair it generates a translation unit holding
+// N obfuscxx<int, Size, Level> objects per obf_level plus a plain `volatile int` baseline, compiles each one with the
+// configured compiler, and records wall time, peak compiler RSS, .text/.rodata/.data/.bss section sizes (`size -A`)
+// and the size of the generated accessor functions (`nm -S`). The obfuscxx objects are non-const, so their padded
+// ciphertext storage normally shows up in .data (or .bss when zero-initialized); a compiler that proves an object is
+// never written may move it to .rodata instead, which is why all four sections are reported. Results go to a JSON
+// file; growth fields are relative to the baseline of the same shape.
+//
+// usage: buildsize-obfuscxx [--out <file.json>] [--work <dir>] [--sizes 1,16,256] [--instances 1,16]
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if !defined(OBFUSCXX_BUILDSIZE_CXX) || !defined(OBFUSCXX_BUILDSIZE_INCLUDE)
+#error "OBFUSCXX_BUILDSIZE_CXX and OBFUSCXX_BUILDSIZE_INCLUDE must be defined by the build"
+#endif
+
+#ifndef OBFUSCXX_BUILDSIZE_FLAGS
+#define OBFUSCXX_BUILDSIZE_FLAGS "-std=c++20 -O2"
+#endif
+
+#ifndef OBFUSCXX_BUILDSIZE_SIZE
+#define OBFUSCXX_BUILDSIZE_SIZE "size"
+#endif
+
+#ifndef OBFUSCXX_BUILDSIZE_NM
+#define OBFUSCXX_BUILDSIZE_NM "nm"
+#endif
+
+namespace {
+    struct options {
+        std::string out = "buildsize.json";
+        std::string work = "buildsize_work";
+        std::vector<std::size_t> sizes{1, 16, 256};
+        std::vector<std::size_t> instances{1, 16};
+    };
+
+    struct measurement {
+        double compile_ms{};
+        long peak_rss_kb{};
+        std::size_t text_bytes{};
+        std::size_t rodata_bytes{};
+        std::size_t data_bytes{};
+        std::size_t bss_bytes{};
+        std::size_t function_bytes{};
+        bool ok{};
+    };
+
+    constexpr const char* levels[] = {"plain", "Low", "Medium", "High"};
+
+    std::vector<std::size_t> parse_list(const std::string& value) {
+        std::vector<std::size_t> list;
+        std::stringstream ss(value);
+        for (std::string item; std::getline(ss, item, ',');) {
+            list.push_back(std::stoul(item));
+        }
+        return list;
+    }
+
+    std::vector<std::string> split_flags(const std::string& flags) {
+        std::vector<std::string> list;
+        std::stringstream ss(flags);
+        for (std::string item; ss >> item;) {
+            list.push_back(item);
+        }
+        return list;
+    }
+
+    int element(std::size_t instance, std::size_t k) {
+        return static_cast<int>(((instance * 131) + (k * 7)) & 0xFFFF);
+    }
+
+    // Every instance gets an indexed accessor and, for arrays, a bulk copy, so both code paths are instantiated.
+    std::string generate(const std::string& level, std::size_t size, std::size_t instances) {
+        bool const plain = level == "plain";
+        std::ostringstream src;
+        src << "#include <cstddef>\n";
+        if (!plain) {
+            src << "#include <obfuscxx/obfuscxx.h>\n";
+        }
+        for (std::size_t n{}; n < instances; ++n) {
+            if (plain) {
+                src << "static volatile int value_" << n << "[" << size << "] = {";
+            } else {
+                src << "static ngu::obfuscxx<int, " << size << ", ngu::obf_level::" << level << "> value_" << n
+                    << (size == 1 ? "(" : "{");
+            }
+            for (std::size_t k{}; k < size; ++k) {
+                src << (k ? ", " : "") << element(n, k);
+            }
+            src << (plain ? "};\n" : (size == 1 ? ");\n" : "};\n"));
+
+            src << "extern \"C\" int obfuscxx_bench_get_" << n << "(std::size_t i) { return ";
+            if (plain) {
+                src << "value_" << n << "[i];";
+            } else {
+                src << (size == 1 ? "static_cast<void>(i), value_" : "value_") << n << (size == 1 ? ".get();" : "[i];");
+            }
+            src << " }\n";
+
+            if (size > 1) {
+                src << "extern \"C\" void obfuscxx_bench_copy_" << n << "(int* out) { ";
+                if (plain) {
+                    src << "for (std::size_t k = 0; k < " << size << "; ++k) out[k] = value_" << n << "[k];";
+                } else {
+                    src << "value_" << n << ".copy_to(out, " << size << ");";
+                }
+                src << " }\n";
+            }
+        }
+        return src.str();
+    }
+
+    std::string read_command(const std::string& command) {
+        std::string output;
+        if (std::FILE* pipe = popen(command.c_str(), "r")) {
+            char buffer[4096];
+            for (std::size_t n; (n = std::fread(buffer, 1, sizeof(buffer), pipe)) != 0;) {
+                output.append(buffer, n);
+            }
+            pclose(pipe);
+        }
+        return output;
+    }
+
+    // Runs the compiler as a direct child so wait4() reports its own peak RSS rather than the process tree's maximum.
+    bool compile(const std::vector<std::string>& args, measurement& m) {
+        std::vector<char*> argv;
+        for (const std::string& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        auto const start = std::chrono::steady_clock::now();
+        pid_t const pid = fork();
+        if (pid == 0) {
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+        if (pid < 0) {
+            return false;
+        }
+
+        int status{};
+        rusage usage{};
+        if (wait4(pid, &status, 0, &usage) != pid) {
+            return false;
+        }
+        m.compile_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+#ifdef __APPLE__
+        m.peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+        m.peak_rss_kb = usage.ru_maxrss;
+#endif
+        return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    void measure_sections(const std::string& object, measurement& m) {
+        std::istringstream lines(read_command(std::string(OBFUSCXX_BUILDSIZE_SIZE) + " -A \"" + object + "\""));
+        for (std::string line; std::getline(lines, line);) {
+            std::istringstream fields(line);
+            std::string section;
+            std::size_t bytes{};
+            if (!(fields >> section >> bytes)) {
+                continue;
+            }
+            if (section.rfind(".text", 0) == 0) {
+                m.text_bytes += bytes;
+            } else if (section.rfind(".rodata", 0) == 0) {
+                m.rodata_bytes += bytes;
+            } else if (section.rfind(".data", 0) == 0) {
+                m.data_bytes += bytes;
+            } else if (section.rfind(".bss", 0) == 0) {
+                m.bss_bytes += bytes;
+            }
+        }
+    }
+
+    void measure_functions(const std::string& object, measurement& m) {
+        std::istringstream lines(read_command(std::string(OBFUSCXX_BUILDSIZE_NM) + " -S \"" + object + "\""));
+        for (std::string line; std::getline(lines, line);) {
+            std::istringstream fields(line);
+            std::string address;
+            std::string size;
+            std::string type;
+            std::string name;
+            if (!(fields >> address >> size >> type >> name)) {
+                continue;
+            }
+            if (name.find("obfuscxx_bench_") != std::string::npos) {
+                m.function_bytes += std::stoul(size, nullptr, 16);
+            }
+        }
+    }
+
+    measurement run(const options& opts, const std::string& level, std::size_t size, std::size_t instances) {
+        std::string const stem = opts.work + "/" + level + "_" + std::to_string(size) + "_" + std::to_string(instances);
+        std::string const source = stem + ".cpp";
+        std::string const object = stem + ".o";
+        std::ofstream(source) << generate(level, size, instances);
+
+        std::vector<std::string> args{OBFUSCXX_BUILDSIZE_CXX};
+        for (std::string& flag : split_flags(OBFUSCXX_BUILDSIZE_FLAGS)) {
+            args.push_back(std::move(flag));
+        }
+        args.insert(args.end(), {"-I", OBFUSCXX_BUILDSIZE_INCLUDE, "-c", source, "-o", object});
+
+        measurement m;
+        m.ok = compile(args, m);
+        if (m.ok) {
+            measure_sections(object, m);
+            measure_functions(object, m);
+        }
+        return m;
+    }
+
+    long long growth(std::size_t value, std::size_t baseline) {
+        return static_cast<long long>(value) - static_cast<long long>(baseline);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string const arg = argv[i];
+        if (arg == "--out") {
+            opts.out = argv[i + 1];
+        } else if (arg == "--work") {
+            opts.work = argv[i + 1];
+        } else if (arg == "--sizes") {
+            opts.sizes = parse_list(argv[i + 1]);
+        } else if (arg == "--instances") {
+            opts.instances = parse_list(argv[i + 1]);
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    std::error_code error;
+    std::filesystem::create_directories(opts.work, error);
+    if (error) {
+        std::fprintf(stderr, "cannot create %s: %s\n", opts.work.c_str(), error.message().c_str());
+        return 1;
+    }
+
+    std::ofstream json(opts.out);
+    json << "{\n  \"compiler\": \"" << OBFUSCXX_BUILDSIZE_CXX << "\",\n  \"flags\": \"" << OBFUSCXX_BUILDSIZE_FLAGS
+         << "\",\n  \"results\": [";
+
+    bool first = true;
+    int failures{};
+    for (std::size_t size : opts.sizes) {
+        for (std::size_t instances : opts.instances) {
+            measurement baseline;
+            for (const char* level : levels) {
+                measurement const m = run(opts, level, size, instances);
+                if (std::string(level) == "plain") {
+                    baseline = m;
+                }
+                failures += m.ok ? 0 : 1;
+
+                json << (first ? "\n" : ",\n") << "    {\"level\": \"" << level << "\", \"size\": " << size
+                     << ", \"instances\": " << instances << ", \"ok\": " << (m.ok ? "true" : "false")
+                     << ", \"compile_ms\": " << m.compile_ms << ", \"peak_rss_kb\": " << m.peak_rss_kb
+                     << ", \"text_bytes\": " << m.text_bytes << ", \"rodata_bytes\": " << m.rodata_bytes
+                     << ", \"data_bytes\": " << m.data_bytes << ", \"bss_bytes\": " << m.bss_bytes
+                     << ", \"function_bytes\": " << m.function_bytes
+                     << ", \"text_growth\": " << growth(m.text_bytes, baseline.text_bytes)
+                     << ", \"rodata_growth\": " << growth(m.rodata_bytes, baseline.rodata_bytes)
+                     << ", \"data_growth\": " << growth(m.data_bytes, baseline.data_bytes)
+                     << ", \"bss_growth\": " << growth(m.bss_bytes, baseline.bss_bytes)
+                     << ", \"function_growth\": " << growth(m.function_bytes, baseline.function_bytes) << "}";
+                first = false;
+
+                std::printf(
+                    "%-6s size=%-5zu instances=%-4zu %9.1f ms %8ld KiB  .text %8zu  .rodata %7zu  .data %7zu  .bss %7zu  "
+                    "functions %8zu\n",
+                    level,
+                    size,
+                    instances,
+                    m.compile_ms,
+                    m.peak_rss_kb,
+                    m.text_bytes,
+                    m.rodata_bytes,
+                    m.data_bytes,
+                    m.bss_bytes,
+                    m.function_bytes
+                );
+            }
+        }
+    }
+    json << "\n  ]\n}\n";
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2025-2026 nevergiveupcpp
+
+// Copyright 2025-2026 nevergiveupcpp
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Round trip through the obfuscxx_embed() CMake function: this file is encrypted by the host tool at build time and
+// the generated blob is decrypted and compared with the file on disk.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <obfuscxx/obfuscxx.h>
+#include <obfuscxx_embed/embedded_source.h>
+
+#ifndef OBFUSCXX_EMBED_INPUT
+#error "OBFUSCXX_EMBED_INPUT must name the file passed to obfuscxx_embed()"
+#endif
+
+namespace {
+    std::vector<std::uint8_t> read_input() {
+        std::ifstream in(OBFUSCXX_EMBED_INPUT, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+} // namespace
+
+TEST(ObfuscxxEmbedTest, GeneratedHeaderRoundTrip) {
+    std::vector<std::uint8_t> const expected = read_input();
+    ASSERT_EQ(embedded::embedded_source.size(), expected.size());
+
+    std::vector<std::uint8_t> out(expected.size());
+    embedded::embedded_source.copy_to(out.data(), out.size());
+    EXPECT_EQ(out, expected);
+
+    for (std::size_t i{}; i < expected.size(); i += 97) {
+        EXPECT_EQ(embedded::embedded_source[i], expected[i]);
+    }
+
+    std::array<std::uint8_t, 40> slice{};
+    embedded::embedded_source.copy_to(slice.data(), 13, slice.size());
+    EXPECT_TRUE(std::equal(slice.begin(), slice.end(), expected.begin() + 13));
+}
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2025-2026 nevergiveupcpp
+
+// Copyright 2025-2026 nevergiveupcpp
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Second translation unit of the SharedLiterals test: the linker has to fold its shared_literal instance with the one
+// odr-used in unittest.cpp.
+
+#include <obfuscxx/obfuscxx.h>
+
+#if defined(OBFUSCXX_ENTROPY_SEED)
+const void* shared_literal_from_other_unit() {
+    return &ngu::shared_literal<"shared across units">;
+}
+
+const char* shared_string_from_other_unit() {
+    static auto plain = ngu::detail::shared_string<"shared across units">();
+    return plain.c_str();
+}
+#endif
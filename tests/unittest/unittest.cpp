@@ -18,7 +18,18 @@
 #ifndef NGU_OBFUSCXX_METRICS_UNITTEST_H
 #define NGU_OBFUSCXX_METRICS_UNITTEST_H
 
+#include <algorithm>
 #include <array>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <obfuscxx/obfuscxx.h>
@@ -246,6 +257,776 @@ TEST(ObfuscxxTest, IteratorOperations) {
     EXPECT_EQ(count, 5);
 }
 
+TEST(ObfuscxxTest, RandomAccessIterator) {
+    using array_type = obfuscxx<int, 70>;
+    static_assert(std::random_access_iterator<array_type::iterator>);
+    static_assert(std::ranges::random_access_range<const array_type>);
+    static_assert(std::ranges::view<decltype(std::declval<const array_type&>().view())>);
+
+    array_type array{};
+    std::array<int, 70> values{};
+    for (std::size_t i{}; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i * i);
+    }
+    array.assign(values);
+
+    auto it = array.begin();
+    EXPECT_EQ(it[69], 69 * 69);
+    EXPECT_EQ(*(it + 33), 33 * 33);
+    EXPECT_EQ(array.end() - array.begin(), 70);
+    EXPECT_TRUE(it < array.end());
+
+    it += 40;
+    EXPECT_EQ(*it, 40 * 40);
+    --it;
+    EXPECT_EQ(*it, 39 * 39);
+    it -= 39;
+    EXPECT_EQ(*it, 0);
+
+    EXPECT_TRUE(std::ranges::equal(array, values));
+    EXPECT_EQ(*std::ranges::find(array.view(), 25 * 25), 25 * 25);
+    EXPECT_EQ(std::ranges::distance(array.view() | std::views::drop(10)), 60);
+    EXPECT_EQ(*std::ranges::rbegin(array.view()), 69 * 69);
+}
+
+TEST(ObfuscxxTest, RangeDecryption) {
+    obfuscxx<int, 100> array{};
+    std::array<int, 100> values{};
+    for (std::size_t i{}; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i) * 3 - 7;
+    }
+    array.assign(values);
+
+    for (std::size_t offset : {0, 1, 7, 15, 16, 33, 63, 90}) {
+        std::array<int, 10> out{};
+        array.copy_to(out.data(), offset, out.size());
+        for (std::size_t i{}; i < out.size() && offset + i < values.size(); ++i) {
+            EXPECT_EQ(out[i], values[offset + i]) << "offset " << offset;
+        }
+    }
+
+    auto slice = array.decrypt_range<4>(97);
+    EXPECT_EQ(slice.data[0], values[97]);
+    EXPECT_EQ(slice.data[2], values[99]);
+    EXPECT_EQ(slice.data[3], 0);
+
+    std::array<int, 2> untouched{-1, -1};
+    array.copy_to(untouched.data(), 100, 2);
+    EXPECT_EQ(untouched[0], -1);
+
+    obfuscxx str("The quick brown fox jumps over the lazy dog, then naps in the warm afternoon sun.");
+    EXPECT_STREQ(str.substr<5>(4), "quick");
+    EXPECT_STREQ(str.substr<3>(40), "dog");
+    EXPECT_STREQ(str.substr<8>(77), "sun.");
+
+    obfuscxx wstr(L"wide characters here");
+    EXPECT_STREQ(wstr.substr<10>(5).c_str(), L"characters");
+}
+
+TEST(ObfuscxxTest, InterleavedDecryption) {
+    obfuscxx<int, 300, obf_level::High> array{};
+    obfuscxx<std::uint16_t, 500, obf_level::Medium> packed{};
+    std::array<int, 300> values{};
+    std::array<std::uint16_t, 500> narrow{};
+    for (std::size_t i{}; i < narrow.size(); ++i) {
+        narrow[i] = static_cast<std::uint16_t>(i * 131);
+        if (i < values.size()) {
+            values[i] = static_cast<int>(i * 7919);
+        }
+    }
+    array.assign(values);
+    packed.assign(narrow);
+
+    EXPECT_TRUE(std::ranges::equal(array.to_array(), values));
+    EXPECT_TRUE(std::ranges::equal(packed.to_array(), narrow));
+
+    std::array<int, 150> out{};
+    array.copy_to(out.data(), 13, out.size());
+    EXPECT_TRUE(std::ranges::equal(out, std::span<const int>(values).subspan(13, 150)));
+
+    std::array<std::uint16_t, 301> narrow_out{};
+    packed.copy_to(narrow_out.data(), 77, narrow_out.size());
+    EXPECT_TRUE(std::ranges::equal(narrow_out, std::span<const std::uint16_t>(narrow).subspan(77, 301)));
+}
+
+TEST(ObfuscxxTest, ChunkedVisit) {
+    obfuscxx<int, 600> array{};
+    std::array<int, 600> values{};
+    for (std::size_t i{}; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i) ^ 0x5a5a;
+    }
+    array.assign(values);
+
+    std::size_t seen{};
+    std::size_t chunks{};
+    array.for_each_chunk([&](std::span<const int> chunk) {
+        EXPECT_LE(chunk.size(), 256u);
+        for (int value : chunk) {
+            EXPECT_EQ(value, values[seen++]);
+        }
+        ++chunks;
+    });
+    EXPECT_EQ(seen, values.size());
+    EXPECT_EQ(chunks, 3u);
+
+    chunks = 0;
+    array.for_each_chunk<100>([&](std::span<const int> chunk) {
+        EXPECT_EQ(chunk.front(), values[chunks * 100]);
+        return ++chunks < 2;
+    });
+    EXPECT_EQ(chunks, 2u);
+
+    obfuscxx str("chunked visitor over a string");
+    std::string text;
+    str.visit<7>([&](char c) {
+        if (c != '\0') {
+            text.push_back(c);
+        }
+    });
+    EXPECT_EQ(text, "chunked visitor over a string");
+
+    std::size_t visited{};
+    array.visit([&](int value) {
+        ++visited;
+        return value != values[299];
+    });
+    EXPECT_EQ(visited, 300u);
+}
+
+TEST(ObfuscxxTest, DecryptAll) {
+    obfuscxx<int> a{-42};
+    obfuscxx<float, 1, obf_level::Medium> b{3.5f};
+    obfuscxx<std::uint64_t, 1, obf_level::High> c{0x0123456789abcdefULL};
+    obfuscxx<char, 1, obf_level::High> d{'x'};
+    obfuscxx<double> e{-2.25};
+    obfuscxx<bool, 1, obf_level::Medium> f{true};
+
+    auto [va, vb, vc, vd, ve, vf] = ngu::decrypt_all(a, b, c, d, e, f);
+    static_assert(std::is_same_v<decltype(vb), float>);
+    EXPECT_EQ(va, -42);
+    EXPECT_EQ(vb, 3.5f);
+    EXPECT_EQ(vc, 0x0123456789abcdefULL);
+    EXPECT_EQ(vd, 'x');
+    EXPECT_EQ(ve, -2.25);
+    EXPECT_TRUE(vf);
+
+    auto [single] = ngu::decrypt_all(c);
+    EXPECT_EQ(single, c.get());
+}
+
+TEST(ObfuscxxTest, CiphertextEquality) {
+    using array_type = obfuscxx<int, 5, obf_level::Medium, 0x1234>;
+    array_type a{1, 2, 3, 4, 5};
+    array_type b{1, 2, 3, 4, 5};
+    array_type c{1, 2, 3, 4, 6};
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+
+    c.set(5, 4);
+    EXPECT_EQ(a, c);
+
+    // The runtime read-modify-write of the partial last block must not leave stale padding lanes behind.
+    using packed_type = obfuscxx<char, 5, obf_level::Low, 0x5678>;
+    packed_type compile_time{'a', 'b', 'c', 'd', 'e'};
+    packed_type runtime{};
+    runtime.assign("abcde", 5);
+    EXPECT_EQ(compile_time, runtime);
+
+    using single_type = obfuscxx<float, 1, obf_level::High, 0x9abc>;
+    single_type x{1.5f};
+    single_type y{1.5f};
+    EXPECT_EQ(x, y);
+    y = 2.5f;
+    EXPECT_NE(x, y);
+
+    // Floating-point values compare as values, not as bits.
+    single_type pos_zero{0.0f};
+    single_type neg_zero{-0.0f};
+    EXPECT_EQ(pos_zero, neg_zero);
+    single_type nan{std::numeric_limits<float>::quiet_NaN()};
+    EXPECT_FALSE(nan == nan);
+
+    using float_array = obfuscxx<float, 300, obf_level::Low, 0xdef0>;
+    std::array<float, 300> floats{};
+    for (std::size_t i{}; i < floats.size(); ++i) {
+        floats[i] = static_cast<float>(i) * 0.5f;
+    }
+    float_array lhs{};
+    float_array rhs{};
+    lhs.assign(floats);
+    floats[0] = -0.0f;
+    rhs.assign(floats);
+    EXPECT_EQ(lhs, rhs);
+    floats[299] = 1.0f;
+    rhs.assign(floats);
+    EXPECT_NE(lhs, rhs);
+    static_assert(!std::is_default_constructible_v<std::hash<float_array>>);
+
+    std::unordered_set<array_type> set;
+    set.insert(a);
+    set.insert(b);
+    set.insert(c);
+    EXPECT_EQ(set.size(), 1u);
+    EXPECT_EQ(std::hash<array_type>{}(a), std::hash<array_type>{}(b));
+    EXPECT_TRUE(set.contains(array_type{1, 2, 3, 4, 5}));
+    EXPECT_FALSE(set.contains(array_type{5, 4, 3, 2, 1}));
+}
+
+TEST(ObfuscxxTest, ObfuscatedMap) {
+    static constexpr obfuscxx_map<const char*, int, 4, obf_level::Medium> ports{{
+        {"http", 80},
+        {"https", 443},
+        {"ssh", 22},
+        {"dns", 53},
+    }};
+    EXPECT_EQ(ports.get("https"), 443);
+    EXPECT_EQ(ports.get("ssh"), 22);
+    EXPECT_EQ(ports.get("ftp", -1), -1);
+    EXPECT_TRUE(ports.contains("dns"));
+    EXPECT_FALSE(ports.contains("smtp"));
+
+    int value{};
+    EXPECT_TRUE(ports.find("http", value));
+    EXPECT_EQ(value, 80);
+
+    // The fingerprint ignores case, the stored key text does not.
+    EXPECT_FALSE(ports.contains("SSH"));
+    EXPECT_FALSE(ports.contains("Http"));
+    EXPECT_FALSE(ports.contains("https-with-a-query-longer-than-the-key-capacity"));
+
+    static constexpr obfuscxx_map<const char*, int, 3, obf_level::High> cased{{
+        {"Path", 1},
+        {"PATH", 2},
+        {"a-key-that-fills-all-32-bytes-xx", 3},
+    }};
+    EXPECT_EQ(cased.get("Path"), 1);
+    EXPECT_EQ(cased.get("PATH"), 2);
+    EXPECT_EQ(cased.get("path", -1), -1);
+    EXPECT_EQ(cased.get("a-key-that-fills-all-32-bytes-xx"), 3);
+    EXPECT_FALSE(cased.contains("a-key-that-fills-all-32-bytes-x"));
+    EXPECT_FALSE(cased.contains("a-key-that-fills-all-32-bytes-xxx"));
+
+    static constexpr obfuscxx_map<const char*, int, 1, obf_level::Low, 0x1234, 64> long_keys{{
+        {"a key longer than the default thirty-two byte capacity", 7},
+    }};
+    EXPECT_EQ(long_keys.get("a key longer than the default thirty-two byte capacity"), 7);
+
+    static constexpr obfuscxx_map<std::uint32_t, std::uint16_t, 40, obf_level::High> squares{{
+        {0, 0},     {1, 1},     {2, 4},     {3, 9},     {4, 16},    {5, 25},    {6, 36},    {7, 49},
+        {8, 64},    {9, 81},    {10, 100},  {11, 121},  {12, 144},  {13, 169},  {14, 196},  {15, 225},
+        {16, 256},  {17, 289},  {18, 324},  {19, 361},  {20, 400},  {21, 441},  {22, 484},  {23, 529},
+        {24, 576},  {25, 625},  {26, 676},  {27, 729},  {28, 784},  {29, 841},  {30, 900},  {31, 961},
+        {32, 1024}, {33, 1089}, {34, 1156}, {35, 1225}, {36, 1296}, {37, 1369}, {38, 1444}, {39, 1521},
+    }};
+    for (std::uint32_t i{}; i < 40; ++i) {
+        EXPECT_EQ(squares.get(i), i * i);
+    }
+    EXPECT_FALSE(squares.contains(40));
+    EXPECT_FALSE(squares.contains(0xFFFFFFFF));
+}
+
+TEST(ObfuscxxTest, ScopedPlain) {
+    obfuscxx<int, 1, obf_level::High> scale{7};
+    int sum{};
+    {
+        auto plain = scale.lock();
+        for (int i{}; i < 10; ++i) {
+            sum += *plain;
+        }
+        EXPECT_EQ(plain.get(), 7);
+    }
+    EXPECT_EQ(sum, 70);
+
+    obfuscxx<std::uint8_t, 20> table{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+    ngu::scoped_plain plain(table);
+    static_assert(std::is_same_v<decltype(plain), ngu::scoped_plain<std::uint8_t, 20>>);
+    EXPECT_EQ(plain[0], 1);
+    EXPECT_EQ(plain[19], 20);
+    EXPECT_EQ(std::accumulate(plain.begin(), plain.end(), 0), 210);
+
+    alignas(std::uint64_t) unsigned char secret[16];
+    std::memset(secret, 0xAB, sizeof(secret));
+    ngu::detail::secure_wipe(secret, sizeof(secret));
+    EXPECT_TRUE(std::all_of(std::begin(secret), std::end(secret), [](unsigned char c) { return c == 0; }));
+}
+
+TEST(ObfuscxxTest, StringViewArena) {
+    obfuscxx greeting("arena backed string");
+    obfuscxx wide(L"wide arena string");
+    const char* first{};
+    {
+        plaintext_scope scope;
+        std::string_view const view = greeting.to_string_view();
+        std::wstring_view const wview = wide.to_string_view();
+        EXPECT_EQ(view, "arena backed string");
+        EXPECT_EQ(view.data()[view.size()], '\0');
+        EXPECT_EQ(wview, L"wide arena string");
+        EXPECT_EQ(obfussv("macro view"), "macro view");
+        first = view.data();
+
+        // Nested scopes release only what they allocated.
+        {
+            plaintext_scope inner;
+            EXPECT_EQ(greeting.to_string_view(), "arena backed string");
+        }
+        EXPECT_EQ(view, "arena backed string");
+    }
+
+    // Closing the scope wipes the plaintext and the space is handed out again.
+    EXPECT_TRUE(std::all_of(first, first + 19, [](char c) { return c == '\0'; }));
+    {
+        plaintext_scope scope;
+        EXPECT_EQ(greeting.to_string_view().data(), first);
+    }
+
+    // Strings larger than the arena spill into heap chunks.
+    std::array<char, OBFUSCXX_ARENA_SIZE + 100> text{};
+    for (std::size_t i{}; i + 1 < text.size(); ++i) {
+        text[i] = static_cast<char>('a' + (i % 26));
+    }
+    obfuscxx<char, OBFUSCXX_ARENA_SIZE + 100> large{};
+    large.assign(text.data(), text.size());
+    {
+        plaintext_scope scope;
+        std::string_view const view = large.to_string_view();
+        EXPECT_EQ(view.size(), text.size() - 1);
+        EXPECT_EQ(view, std::string_view(text.data()));
+    }
+}
+
+TEST(ObfuscxxTest, EmbeddedBlob) {
+    // Same packing and padding obfuscxx_embed emits: eight bytes per block, padded to 16 blocks.
+    constexpr std::uint64_t entropy = 0x5EEDULL;
+    std::array<std::uint8_t, 100> data{};
+    for (std::size_t i{}; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint8_t>((i * 37) ^ 0x5A);
+    }
+
+    auto const key = ngu::detail::make_xtea_key(entropy, obf_level::High);
+    alignas(64) static std::uint64_t storage[16]{};
+    for (std::size_t i{}; i < (data.size() + 7) / 8; ++i) {
+        std::uint64_t block{};
+        for (std::size_t j{}; j < 8 && (i * 8) + j < data.size(); ++j) {
+            block |= static_cast<std::uint64_t>(data[(i * 8) + j]) << (j * 8);
+        }
+        storage[i] = ngu::detail::xtea_encrypt(key, block);
+    }
+
+    obfuscxx_blob<std::uint8_t, 100, obf_level::High, entropy> blob{storage};
+    EXPECT_EQ(blob.size(), 100u);
+    for (std::size_t i{}; i < data.size(); ++i) {
+        EXPECT_EQ(blob[i], data[i]);
+    }
+
+    std::array<std::uint8_t, 100> out{};
+    blob.copy_to(out.data(), out.size());
+    EXPECT_EQ(out, data);
+
+    std::array<std::uint8_t, 10> slice{};
+    blob.copy_to(slice.data(), 93, slice.size());
+    EXPECT_TRUE(std::equal(slice.begin(), slice.begin() + 7, data.begin() + 93));
+    EXPECT_EQ(slice[7], 0);
+}
+
+TEST(ObfuscxxTest, AtomicValue) {
+    obfuscxx_atomic<int, obf_level::Medium> counter{0};
+    EXPECT_EQ(counter.load(), 0);
+
+    std::vector<std::thread> threads;
+    for (int t{}; t < 4; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i{}; i < 1000; ++i) {
+                int expected = counter.load(std::memory_order_relaxed);
+                while (!counter.compare_exchange_weak(expected, expected + 1)) {
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.load(), 4000);
+
+    EXPECT_EQ(counter.exchange(7), 4000);
+    int expected = 1;
+    EXPECT_FALSE(counter.compare_exchange_strong(expected, 2));
+    EXPECT_EQ(expected, 7);
+    EXPECT_TRUE(counter.compare_exchange_strong(expected, 2));
+    counter.store(-5);
+    EXPECT_EQ(static_cast<int>(counter), -5);
+}
+
+TEST(ObfuscxxTest, SeqlockArray) {
+    obfuscxx_seqlock<std::uint32_t, 64, obf_level::High> table{0};
+    EXPECT_EQ(table.version(), 0u);
+
+    std::array<std::uint32_t, 64> ones{};
+    std::array<std::uint32_t, 64> twos{};
+    ones.fill(1);
+    twos.fill(2);
+
+    // The list only initializes element 0; the rest reads as noise until the first full write, so that happens
+    // before any reader starts.
+    table.assign(twos.data(), 64);
+    EXPECT_EQ(table.version(), 1u);
+
+    std::atomic<bool> done{};
+    std::atomic<int> torn{};
+    std::vector<std::thread> readers;
+    for (int t{}; t < 3; ++t) {
+        readers.emplace_back([&] {
+            std::array<std::uint32_t, 64> out{};
+            while (!done.load()) {
+                table.copy_to(out.data(), out.size());
+                if (!std::all_of(out.begin(), out.end(), [&](std::uint32_t v) { return v == out[0]; })) {
+                    torn.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (int i{1}; i <= 2000; ++i) {
+        table.assign((i & 1) != 0 ? ones.data() : twos.data(), 64);
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(table.version(), 2001u);
+    EXPECT_EQ(table[63], 2u);
+    table.set(9, 10);
+    EXPECT_EQ(table.get(10), 9u);
+    EXPECT_EQ(table.get(11), 2u);
+}
+
+TEST(ObfuscxxTest, SeqlockRanges) {
+    // Packed elements over several read windows, in counter mode, where block positions feed the keystream.
+    obfuscxx_seqlock<std::uint16_t, 1003, obf_level::Medium, 0x1234, ctr<>> table{0};
+    std::array<std::uint16_t, 1003> values{};
+    std::iota(values.begin(), values.end(), std::uint16_t{7});
+    table.assign(values.data(), values.size());
+
+    std::array<std::uint16_t, 1003> out{};
+    for (std::size_t offset : {0, 1, 3, 63, 64, 255, 257, 700, 1000}) {
+        for (std::size_t count : {1, 5, 64, 300, 1003}) {
+            out.fill(0);
+            table.copy_to(out.data(), offset, count);
+            std::size_t const n = std::min(count, values.size() - offset);
+            EXPECT_TRUE(std::equal(out.begin(), out.begin() + n, values.begin() + offset)) << offset << " " << count;
+            if (n < out.size()) {
+                EXPECT_EQ(out[n], 0u);
+            }
+        }
+    }
+
+    // A partial write keeps the rest of its last block and of the array.
+    std::array<std::uint16_t, 514> fresh{};
+    fresh.fill(0xbeef);
+    table.assign(fresh.data(), fresh.size());
+    std::copy(fresh.begin(), fresh.end(), values.begin());
+    table.set(0x1111, 1002);
+    table.set(0x2222, 515);
+    values[1002] = 0x1111;
+    values[515] = 0x2222;
+    table.copy_to(out.data(), out.size());
+    EXPECT_TRUE(std::equal(out.begin(), out.end(), values.begin()));
+    for (std::size_t i : {0, 513, 514, 515, 516, 1002}) {
+        EXPECT_EQ(table.get(i), values[i]);
+    }
+
+    struct wide_value {
+        std::uint64_t lo;
+        std::uint64_t hi;
+        std::uint64_t tag;
+    };
+    obfuscxx_seqlock<wide_value, 50, obf_level::Low, 0x1234> wide{wide_value{}};
+    std::array<wide_value, 50> wide_values{};
+    for (std::size_t i{}; i < wide_values.size(); ++i) {
+        wide_values[i] = {i, ~i, i * 3};
+    }
+    wide.assign(wide_values.data(), wide_values.size());
+    wide.set(wide_value{1, 2, 3}, 37);
+    wide_values[37] = {1, 2, 3};
+    std::array<wide_value, 50> wide_out{};
+    wide.copy_to(wide_out.data(), 5, 45);
+    for (std::size_t i{}; i < 45; ++i) {
+        EXPECT_EQ(wide_out[i].lo, wide_values[i + 5].lo);
+        EXPECT_EQ(wide_out[i].hi, wide_values[i + 5].hi);
+        EXPECT_EQ(wide_out[i].tag, wide_values[i + 5].tag);
+    }
+    EXPECT_EQ(wide.get(49).tag, 49u * 3);
+}
+
+TEST(ObfuscxxTest, SpeckCipher) {
+    // Published SPECK 64/128 test vector.
+    constexpr auto key = ngu::detail::expand_speck_key(0x03020100, 0x0b0a0908, 0x13121110, 0x1b1a1918, 27);
+    static_assert(ngu::detail::speck_encrypt(key, 0x3b7265747475432dULL) == 0x8c6fa548454e028bULL);
+
+    obfuscxx<int, 1, obf_level::Low, OBFUSCXX_ENTROPY, speck> low{42};
+    obfuscxx<int, 1, obf_level::Medium, OBFUSCXX_ENTROPY, speck> medium{-7};
+    obfuscxx<double, 1, obf_level::High, OBFUSCXX_ENTROPY, speck> high{3.25};
+    EXPECT_EQ(low.get(), 42);
+    EXPECT_EQ(medium.get(), -7);
+    EXPECT_EQ(high.get(), 3.25);
+
+    obfuscxx<std::uint16_t, 100, obf_level::High, OBFUSCXX_ENTROPY, speck> array{};
+    std::array<std::uint16_t, 100> values{};
+    std::iota(values.begin(), values.end(), std::uint16_t{1000});
+    array.assign(values.data(), values.size());
+    std::array<std::uint16_t, 100> out{};
+    array.copy_to(out.data(), out.size());
+    EXPECT_EQ(out, values);
+    array.set(5, 3);
+    EXPECT_EQ(array[3], 5);
+    EXPECT_EQ(array[99], 1099);
+
+    obfuscxx<char, 13, obf_level::Medium, OBFUSCXX_ENTROPY, speck> str("speck cipher");
+    EXPECT_STREQ(str.to_string(), "speck cipher");
+
+    auto [a, b] = ngu::decrypt_all(low, medium);
+    EXPECT_EQ(a, 42);
+    EXPECT_EQ(b, -7);
+}
+
+TEST(ObfuscxxTest, CtrMode) {
+    using keystream = ctr<>::engine<obf_level::Medium, 0x1234>;
+    static_assert(keystream::keystream(0) != keystream::keystream(1));
+
+    obfuscxx<int, 1, obf_level::Low, OBFUSCXX_ENTROPY, ctr<>> single{42};
+    obfuscxx<double, 1, obf_level::High, OBFUSCXX_ENTROPY, ctr<speck>> high{3.25};
+    EXPECT_EQ(single.get(), 42);
+    EXPECT_EQ(high.get(), 3.25);
+    single = -9;
+    EXPECT_EQ(single.get(), -9);
+
+    // Equal blocks at different positions encrypt differently.
+    using same_type = obfuscxx<std::uint64_t, 4, obf_level::Medium, 0x1234, ctr<>>;
+    same_type same{7, 7, 7, 7};
+    const auto* raw = reinterpret_cast<const volatile std::uint64_t*>(&same);
+    EXPECT_NE(raw[0], raw[1]);
+    EXPECT_EQ(same[3], 7u);
+
+    // Runtime writes produce the same ciphertext as the consteval constructor.
+    same_type runtime{};
+    std::array<std::uint64_t, 4> const sevens{7, 7, 7, 7};
+    runtime.assign(sevens.data(), sevens.size());
+    EXPECT_EQ(runtime, same);
+
+    obfuscxx<std::uint16_t, 203, obf_level::High, OBFUSCXX_ENTROPY, ctr<>> packed{};
+    std::array<std::uint16_t, 203> values{};
+    std::iota(values.begin(), values.end(), std::uint16_t{500});
+    packed.assign(values.data(), values.size());
+    std::array<std::uint16_t, 203> out{};
+    packed.copy_to(out.data(), out.size());
+    EXPECT_EQ(out, values);
+    std::array<std::uint16_t, 60> slice{};
+    packed.copy_to(slice.data(), 37, slice.size());
+    EXPECT_TRUE(std::equal(slice.begin(), slice.end(), values.begin() + 37));
+    packed.set(1, 150);
+    EXPECT_EQ(packed[150], 1);
+    EXPECT_EQ(packed[151], 651);
+    EXPECT_EQ(std::accumulate(packed.begin(), packed.end(), 0), std::accumulate(values.begin(), values.end(), 0) - 649);
+
+    obfuscxx<int, 37, obf_level::Medium, OBFUSCXX_ENTROPY, ctr<speck>> ints{};
+    for (int i{}; i < 37; ++i) {
+        ints.set(i * 3, i);
+    }
+    std::array<int, 37> ints_out{};
+    ints.copy_to(ints_out.data(), ints_out.size());
+    for (int i{}; i < 37; ++i) {
+        EXPECT_EQ(ints_out[i], i * 3);
+    }
+
+    obfuscxx<char, 45, obf_level::Medium, OBFUSCXX_ENTROPY, ctr<>> str("counter mode keeps every block independent!!");
+    EXPECT_STREQ(str.to_string(), "counter mode keeps every block independent!!");
+}
+
+TEST(ObfuscxxTest, OutlinedKernels) {
+    static_assert(outlined::engine<obf_level::High, 0x1234>::out_of_line);
+
+    // Only the decryption path moves out of line, so the ciphertext is that of the default XTEA policy.
+    std::array<int, 37> values{};
+    std::iota(values.begin(), values.end(), -11);
+    obfuscxx<int, 37, obf_level::High, 0x1234, outlined> shared{};
+    obfuscxx<int, 37, obf_level::High, 0x1234, xtea> inlined{};
+    shared.assign(values.data(), values.size());
+    inlined.assign(values.data(), values.size());
+    const auto* shared_raw = reinterpret_cast<const volatile std::uint64_t*>(&shared);
+    const auto* inlined_raw = reinterpret_cast<const volatile std::uint64_t*>(&inlined);
+    for (std::size_t i{}; i < 19; ++i) {
+        EXPECT_EQ(shared_raw[i], inlined_raw[i]);
+    }
+
+    std::array<int, 37> out{};
+    shared.copy_to(out.data(), out.size());
+    EXPECT_EQ(out, values);
+    std::array<int, 20> slice{};
+    shared.copy_to(slice.data(), 9, slice.size());
+    EXPECT_TRUE(std::equal(slice.begin(), slice.end(), values.begin() + 9));
+    shared.set(1000, 36);
+    EXPECT_EQ(shared[36], 1000);
+    EXPECT_EQ(shared[35], values[35]);
+
+    obfuscxx<int, 1, obf_level::Low, OBFUSCXX_ENTROPY, outlined> single{42};
+    obfuscxx<double, 1, obf_level::Medium, OBFUSCXX_ENTROPY, outlined> real{3.25};
+    EXPECT_EQ(single.get(), 42);
+    EXPECT_EQ(real.get(), 3.25);
+    single = -9;
+    EXPECT_EQ(single.get(), -9);
+
+    obfuscxx<char, 30, obf_level::Medium, OBFUSCXX_ENTROPY, outlined> str("one kernel for every instance");
+    EXPECT_STREQ(str.to_string(), "one kernel for every instance");
+
+    // Tables larger than one batch of the shared kernel.
+    obfuscxx<std::uint16_t, 700, obf_level::High, OBFUSCXX_ENTROPY, outlined> packed{};
+    std::array<std::uint16_t, 700> wide{};
+    std::iota(wide.begin(), wide.end(), std::uint16_t{100});
+    packed.assign(wide.data(), wide.size());
+    std::array<std::uint16_t, 700> wide_out{};
+    packed.copy_to(wide_out.data(), wide_out.size());
+    EXPECT_EQ(wide_out, wide);
+    std::array<std::uint16_t, 400> wide_slice{};
+    packed.copy_to(wide_slice.data(), 213, wide_slice.size());
+    EXPECT_TRUE(std::equal(wide_slice.begin(), wide_slice.end(), wide.begin() + 213));
+}
+
+TEST(ObfuscxxTest, LevelOverrides) {
+    using hot_type = obfuscxx<int, 1, obf_level::High, 0x1234>;
+    using cold_type = obfuscxx<float, 1, obf_level::High, 0x1234>;
+    constexpr std::uint64_t hot_site = ngu::detail::site_id<hot_type>();
+    constexpr std::uint64_t cold_site = ngu::detail::site_id<cold_type>();
+    static_assert(hot_site == ngu::detail::site_id<hot_type>());
+    static_assert(hot_site != cold_site);
+
+    constexpr ngu::detail::level_override table[] = {{hot_site, obf_level::Low}, {0, obf_level::Low}};
+    static_assert(ngu::detail::resolve_level(hot_site, obf_level::High, table) == obf_level::Low);
+    static_assert(ngu::detail::resolve_level(cold_site, obf_level::High, table) == obf_level::High);
+    static_assert(ngu::detail::resolve_level(0, obf_level::Medium, table) == obf_level::Medium);
+
+    // Without OBFUSCXX_LEVEL_OVERRIDES every instance keeps its declared level.
+    static_assert(hot_type::level() == obf_level::High);
+    static_assert(obfuscxx<char, 4, obf_level::Medium>::level() == obf_level::Medium);
+    EXPECT_EQ(hot_type{5}.get(), 5);
+}
+
+TEST(ObfuscxxTest, WideTypes) {
+    struct guid {
+        std::uint32_t data1;
+        std::uint16_t data2;
+        std::uint16_t data3;
+        std::uint8_t data4[8];
+        bool operator==(const guid&) const = default;
+    };
+    struct key256 {
+        std::uint64_t words[4];
+        bool operator==(const key256&) const = default;
+    };
+    struct name13 {
+        char text[13];
+    };
+    struct point {
+        std::int16_t x;
+        std::int16_t y;
+        bool operator==(const point&) const = default;
+    };
+
+    guid const id{0x6B29FC40, 0xCA47, 0x1067, {0xB3, 0x1D, 0x00, 0xDD, 0x01, 0x06, 0x62, 0xDA}};
+    obfuscxx<guid> obf_id{id};
+    EXPECT_EQ(obf_id.get(), id);
+
+    obfuscxx<key256, 1, obf_level::High> key{key256{{1, 2, 3, ~0ULL}}};
+    EXPECT_EQ(key.get(), (key256{{1, 2, 3, ~0ULL}}));
+    key = key256{{9, 8, 7, 6}};
+    EXPECT_EQ(key.get(), (key256{{9, 8, 7, 6}}));
+    const auto* raw = reinterpret_cast<const volatile std::uint64_t*>(&key);
+    EXPECT_NE(raw[0], 9u);
+    EXPECT_NE(raw[3], 6u);
+
+    __int128 const big = (static_cast<__int128>(0x0123456789ABCDEF) << 64) | 0x1122334455667788;
+    obfuscxx<__int128, 1, obf_level::Medium> obf_big{big};
+    EXPECT_TRUE(obf_big.get() == big);
+
+    // Sizes that are not a multiple of eight leave the tail of the last word zero.
+    obfuscxx<name13, 5, obf_level::Medium> names{name13{"hello world!"}, name13{"abc"}, name13{"x"}, name13{"yy"},
+                                                 name13{"zzz"}};
+    EXPECT_STREQ(names[0].text, "hello world!");
+    std::array<name13, 4> tail{};
+    names.copy_to(tail.data(), 1, tail.size());
+    EXPECT_STREQ(tail[0].text, "abc");
+    EXPECT_STREQ(tail[3].text, "zzz");
+    names.set(name13{"changed"}, 2);
+    EXPECT_STREQ(names[2].text, "changed");
+    EXPECT_STREQ(names[3].text, "yy");
+
+    // Enough elements for several vector groups and interleaved kernels.
+    obfuscxx<key256, 37, obf_level::High, OBFUSCXX_ENTROPY, ctr<>> keys{};
+    std::array<key256, 37> values{};
+    for (std::uint64_t i{}; i < values.size(); ++i) {
+        values[i] = key256{{i, i * 3, i * 5, ~i}};
+    }
+    keys.assign(values.data(), values.size());
+    std::array<key256, 37> out{};
+    keys.copy_to(out.data(), out.size());
+    EXPECT_EQ(out, values);
+    EXPECT_EQ(keys[36], values[36]);
+    EXPECT_TRUE(std::equal(keys.begin(), keys.end(), values.begin()));
+
+    // Structs of eight bytes or less keep using one block.
+    obfuscxx<point> origin{point{-3, 4}};
+    obfuscxx<point, 3> path{point{1, 2}, point{3, 4}, point{5, 6}};
+    EXPECT_EQ(origin.get(), (point{-3, 4}));
+    EXPECT_EQ(path[2], (point{5, 6}));
+
+    auto [first, second] = decrypt_all(obf_id, origin);
+    EXPECT_EQ(first, id);
+    EXPECT_EQ(second, (point{-3, 4}));
+}
+
+#if defined(OBFUSCXX_PROFILE)
+TEST(ObfuscxxTest, ProfileCounts) {
+    using profiled = obfuscxx<int, 8, obf_level::High, 0x4242>;
+    profiled table{1, 2, 3, 4, 5, 6, 7, 8};
+    int sum{};
+    for (int i{}; i < 8; ++i) {
+        sum += table[i];
+    }
+    EXPECT_EQ(sum, 36);
+
+    std::FILE* file = std::tmpfile();
+    ngu::write_profile(file);
+    std::rewind(file);
+    // Eight operator[] calls, declared level, size; the construction site follows.
+    char site[64]{};
+    auto const id = static_cast<unsigned long long>(ngu::detail::site_id<profiled>());
+    std::snprintf(site, sizeof(site), "0x%016llx 8 High 8 ", id);
+    bool found{};
+    for (char line[512]; std::fgets(line, sizeof(line), file) != nullptr;) {
+        found = found || std::strncmp(line, site, std::strlen(site)) == 0;
+    }
+    std::fclose(file);
+    EXPECT_TRUE(found);
+}
+#endif
+
+#if defined(OBFUSCXX_TRACE)
+TEST(ObfuscxxTest, TraceCounters) {
+    using traced = obfuscxx<std::uint32_t, 40, obf_level::Medium, 0x7777>;
+    traced table{};
+    table.set(1, 3);
+    EXPECT_EQ(table[3], 1u);
+    std::array<std::uint32_t, 40> out{};
+    table.copy_to(out.data(), out.size());
+    EXPECT_EQ(out[3], 1u);
+
+    ngu::flush_trace();
+    ngu::trace_stats const stats = ngu::trace_of<traced>();
+    EXPECT_EQ(stats.scalar_decrypts, 2u); // read-modify-write in set(), then operator[]
+    EXPECT_GE(stats.vector_decrypts, 20u);
+    EXPECT_EQ(stats.runtime_encrypts, 1u);
+}
+#endif
+
 TEST(ObfuscxxTest, DifferentTypes) {
     obfuscxx<uint64_t> u64{0xFFFFFFFFFFFFFFFF};
     obfuscxx<int8_t> i8{-127};
@@ -289,6 +1070,101 @@ TEST(ObfuscxxTest, ImplicitConversion) {
     EXPECT_EQ(result, 52);
 }
 
+TEST(ObfuscxxTest, PackedNarrowTypes) {
+    obfuscxx<std::int16_t, 7> i16{-1, 2, -3, 4, -5, 6, -32768};
+    obfuscxx<std::uint8_t, 11> u8{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 255};
+    obfuscxx u16(u"packed");
+    obfuscxx<float, 3> f32{1.5f, -2.5f, 3.25f};
+    obfuscxx<bool, 3> flags{true, false, true};
+
+    std::int16_t const expected_i16[] = {-1, 2, -3, 4, -5, 6, -32768};
+    for (std::size_t i{}; i < i16.size(); ++i) {
+        EXPECT_EQ(i16[i], expected_i16[i]);
+    }
+
+    std::uint8_t out_u8[11]{};
+    u8.copy_to(out_u8, 11);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(out_u8[i], i + 1);
+    }
+    EXPECT_EQ(out_u8[10], 255);
+
+    EXPECT_EQ(u16[0], u'p');
+    EXPECT_EQ(u16[6], u'\0');
+    EXPECT_FLOAT_EQ(f32[1], -2.5f);
+    EXPECT_TRUE(flags[0]);
+    EXPECT_FALSE(flags[1]);
+    EXPECT_TRUE(flags[2]);
+
+    i16.set(1234, 3);
+    u8 = {42, 43};
+    EXPECT_EQ(i16[2], -3);
+    EXPECT_EQ(i16[3], 1234);
+    EXPECT_EQ(i16[4], -5);
+    EXPECT_EQ(u8[0], 42);
+    EXPECT_EQ(u8[1], 43);
+    EXPECT_EQ(u8[2], 3);
+
+    EXPECT_LT(sizeof(obfuscxx<char, 256>), 256 * sizeof(std::uint64_t));
+}
+
+TEST(ObfuscxxTest, BulkAssign) {
+    obfuscxx<int, 100> table{};
+    std::array<int, 100> values{};
+    for (std::size_t i{}; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i * 7) - 300;
+    }
+
+    table.assign(values.data(), values.size());
+    for (std::size_t i{}; i < values.size(); ++i) {
+        EXPECT_EQ(table[i], values[i]);
+    }
+
+    int const head[] = {-1, -2, -3};
+    table.assign(std::span<const int>(head));
+    EXPECT_EQ(table[0], -1);
+    EXPECT_EQ(table[2], -3);
+    EXPECT_EQ(table[3], values[3]);
+    EXPECT_EQ(table[99], values[99]);
+
+    obfuscxx<std::uint8_t, 45> bytes{};
+    std::array<std::uint8_t, 45> raw{};
+    for (std::size_t i{}; i < raw.size(); ++i) {
+        raw[i] = static_cast<std::uint8_t>(255 - i);
+    }
+    bytes.assign(raw);
+    raw[0] = 1;
+    raw[12] = 2;
+    bytes.assign(raw.data(), 13);
+
+    std::uint8_t out[45]{};
+    bytes.copy_to(out, 45);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[12], 2);
+    for (std::size_t i = 13; i < raw.size(); ++i) {
+        EXPECT_EQ(out[i], raw[i]);
+    }
+}
+
+TEST(ObfuscxxTest, ActiveKernel) {
+    simd_kernel const kernel = active_kernel();
+    EXPECT_EQ(kernel, active_kernel());
+    EXPECT_STRNE(kernel_name(kernel), "unknown");
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    EXPECT_EQ(kernel, simd_kernel::Neon);
+#elif OBFUSCXX_HAS_AVX512
+    EXPECT_EQ(kernel, simd_kernel::Avx512);
+#endif
+
+#if OBFUSCXX_HAS_DISPATCH && !OBFUSCXX_HAS_AVX512
+    // Only storage the dispatched kernels read takes the AVX-512F layout.
+    static_assert(alignof(obfuscxx<int, 4>) == 64);
+    static_assert(alignof(obfuscxx<int>) < 64);
+    static_assert(sizeof(obfuscxx<int>) < 64);
+#endif
+}
+
 TEST(ObfuscxxTest, RValueDefines) {
     EXPECT_STREQ(obfuss("small test string"), "small test string");
     EXPECT_STREQ(obfuss(L"small test string"), L"small test string");
@@ -297,7 +1173,36 @@ TEST(ObfuscxxTest, RValueDefines) {
     EXPECT_EQ(obfusv(-3.14f), -3.14f);
 }
 
-#if defined(__clang__) || defined(__GNUC__)
+#if defined(OBFUSCXX_ENTROPY_SEED)
+// Defined in shared_literal_unit.cpp.
+const void* shared_literal_from_other_unit();
+const char* shared_string_from_other_unit();
+
+TEST(ObfuscxxTest, SharedLiterals) {
+    static_assert(detail::content_entropy("shared") == detail::content_entropy("shared"));
+    static_assert(detail::content_entropy("shared") != detail::content_entropy("Shared"));
+    static_assert(detail::content_entropy("shared") != detail::content_entropy(L"shared"));
+
+    // Both translation units odr-use the same specialization, which the linker has to fold into one object.
+    auto& first = shared_literal<"shared across units">;
+    EXPECT_EQ(static_cast<const void*>(&first), shared_literal_from_other_unit());
+    EXPECT_STREQ(first.to_string(), "shared across units");
+    EXPECT_STREQ(shared_string_from_other_unit(), "shared across units");
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(first)>,
+                                 obfuscxx<char, 20, obf_level::Low, detail::content_entropy("shared across units")>>);
+
+    auto& high = shared_literal<"shared across units", obf_level::High>;
+    EXPECT_NE(static_cast<const void*>(&high), static_cast<const void*>(&first));
+    EXPECT_STREQ(high.to_string(), "shared across units");
+    EXPECT_STREQ(shared_literal<L"wide shared">.to_string(), L"wide shared");
+
+    EXPECT_STREQ(detail::shared_string<"out of line">().c_str(), "out of line");
+    plaintext_scope scope;
+    EXPECT_EQ(detail::shared_string_view<"out of line">(), "out of line");
+}
+#endif
+
+#if defined(__clang__) || defined(__GNUC__) || defined(OBFUSCXX_DEDUP_LITERALS)
 TEST(ObfuscxxTest, UserDefinedLiterals) {
     EXPECT_STREQ("small test string"_obf, "small test string");
     EXPECT_STREQ(L"small test string"_obf, L"small test string");
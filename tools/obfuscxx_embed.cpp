@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2025-2026 nevergiveupcpp
+
+// Copyright 2025-2026 nevergiveupcpp
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host tool behind the obfuscxx_embed() CMake function. Encrypts a file as the storage of an
+// obfuscxx<std::uint8_t, N, Level, Entropy> array, using the library's own key derivation, and writes a header that
+// exposes it as an ngu::obfuscxx_blob. The compiler only has to parse the array, so asset size no longer runs into
+// consteval step limits.
+//
+// usage: obfuscxx_embed <input> <output.h> <name> [--level low|medium|high] [--entropy <integer>]
+//                       [--namespace <namespace>]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <obfuscxx/obfuscxx.h>
+
+namespace {
+    // Largest storage_multiple / storage_alignment of any build, so the blob fits every SIMD configuration.
+    constexpr std::size_t block_multiple = 16;
+    constexpr std::size_t blocks_per_line = 4;
+
+    struct options {
+        std::string input;
+        std::string output;
+        std::string name;
+        std::string name_space;
+        ngu::obf_level level = ngu::obf_level::Low;
+        const char* level_name = "Low";
+        std::uint64_t entropy{};
+        bool has_entropy{};
+    };
+
+    int usage() {
+        std::fprintf(
+            stderr,
+            "usage: obfuscxx_embed <input> <output.h> <name> [--level low|medium|high] [--entropy <integer>] "
+            "[--namespace <namespace>]\n"
+        );
+        return 1;
+    }
+
+    bool parse_level(const std::string& value, options& opts) {
+        if (value == "low" || value == "Low") {
+            opts.level = ngu::obf_level::Low;
+            opts.level_name = "Low";
+        } else if (value == "medium" || value == "Medium") {
+            opts.level = ngu::obf_level::Medium;
+            opts.level_name = "Medium";
+        } else if (value == "high" || value == "High") {
+            opts.level = ngu::obf_level::High;
+            opts.level_name = "High";
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Accepts decimal, 0x-prefixed hex or 0-prefixed octal, as std::stoull with base 0 does, and nothing after it.
+    bool parse_entropy(const std::string& value, options& opts) {
+        try {
+            std::size_t used{};
+            opts.entropy = std::stoull(value, &used, 0);
+            opts.has_entropy = used == value.size();
+        } catch (const std::logic_error&) {
+            opts.has_entropy = false;
+        }
+        return opts.has_entropy;
+    }
+
+    // Without an explicit entropy every build gets a fresh key, as __TIME__ does for OBFUSCXX_ENTROPY.
+    std::uint64_t default_entropy(const std::string& name) {
+        auto const now = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        return ngu::detail::splitmix64(ngu::detail::hash_runtime(name.c_str()) ^ ngu::detail::rol64(now, 32));
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        return usage();
+    }
+
+    options opts;
+    opts.input = argv[1];
+    opts.output = argv[2];
+    opts.name = argv[3];
+
+    for (int i = 4; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (i + 1 >= argc) {
+            return usage();
+        }
+        std::string const value = argv[++i];
+        if (arg == "--level") {
+            if (!parse_level(value, opts)) {
+                return usage();
+            }
+        } else if (arg == "--entropy") {
+            if (!parse_entropy(value, opts)) {
+                return usage();
+            }
+        } else if (arg == "--namespace") {
+            opts.name_space = value;
+        } else {
+            return usage();
+        }
+    }
+
+    std::ifstream in(opts.input, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "obfuscxx_embed: cannot open %s\n", opts.input.c_str());
+        return 1;
+    }
+    std::vector<unsigned char> const data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < 2) {
+        std::fprintf(stderr, "obfuscxx_embed: %s is shorter than two bytes\n", opts.input.c_str());
+        return 1;
+    }
+
+    if (!opts.has_entropy) {
+        opts.entropy = default_entropy(opts.name);
+    }
+    ngu::detail::xtea_key const key = ngu::detail::make_xtea_key(opts.entropy, opts.level);
+
+    // Eight bytes per block, little-endian, exactly as obfuscxx packs std::uint8_t elements.
+    std::size_t const blocks = (data.size() + 7) / 8;
+    std::size_t const padded = (blocks + block_multiple - 1) / block_multiple * block_multiple;
+
+    std::FILE* out = std::fopen(opts.output.c_str(), "wb");
+    if (out == nullptr) {
+        std::fprintf(stderr, "obfuscxx_embed: cannot write %s\n", opts.output.c_str());
+        return 1;
+    }
+
+    std::string guard = "OBFUSCXX_EMBED_" + opts.name + "_H";
+    for (char& c : guard) {
+        c = (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+    }
+
+    std::fprintf(out, "// Generated by obfuscxx_embed. Do not edit.\n\n");
+    std::fprintf(out, "#ifndef %s\n#define %s\n\n", guard.c_str(), guard.c_str());
+    std::fprintf(out, "#include <cstdint>\n\n#include <obfuscxx/obfuscxx.h>\n\n");
+    if (!opts.name_space.empty()) {
+        std::fprintf(out, "namespace %s {\n", opts.name_space.c_str());
+    }
+
+    std::fprintf(out, "alignas(64) inline const std::uint64_t %s_storage[%zu] = {\n", opts.name.c_str(), padded);
+    for (std::size_t i{}; i < padded; ++i) {
+        std::uint64_t block{};
+        for (std::size_t j{}; j < 8 && (i * 8) + j < data.size(); ++j) {
+            block |= static_cast<std::uint64_t>(data[(i * 8) + j]) << (j * 8);
+        }
+        std::uint64_t const cipher = i < blocks ? ngu::detail::xtea_encrypt(key, block) : 0;
+        bool const line_start = i % blocks_per_line == 0;
+        bool const line_end = i % blocks_per_line == blocks_per_line - 1 || i + 1 == padded;
+        std::fprintf(
+            out,
+            "%s0x%016llxULL,%s",
+            line_start ? "    " : "",
+            static_cast<unsigned long long>(cipher),
+            line_end ? "\n" : " "
+        );
+    }
+    std::fprintf(out, "};\n\n");
+
+    std::fprintf(
+        out,
+        "inline constexpr ngu::obfuscxx_blob<std::uint8_t, %zu, ngu::obf_level::%s, 0x%016llxULL> %s{%s_storage};\n",
+        data.size(),
+        opts.level_name,
+        static_cast<unsigned long long>(opts.entropy),
+        opts.name.c_str(),
+        opts.name.c_str()
+    );
+
+    if (!opts.name_space.empty()) {
+        std::fprintf(out, "} // namespace %s\n", opts.name_space.c_str());
+    }
+    std::fprintf(out, "\n#endif // %s\n", guard.c_str());
+
+    return std::fclose(out) == 0 ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2025-2026 nevergiveupcpp
+
+// Copyright 2025-2026 nevergiveupcpp
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host tool behind the obfuscxx_level_overrides() CMake function. Reads profiles written by an OBFUSCXX_PROFILE build,
+// sums the calls of every obfuscxx instantiation over all its construction sites, and writes an
+// OBFUSCXX_LEVEL_OVERRIDES header that moves the hottest instantiations to a lower level. Instantiations already at or
+// below that level are left alone.
+//
+// usage: obfuscxx_levels <output.h> <profile>... [--hot <percent>] [--level low|medium|high]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct options {
+        std::string output;
+        std::vector<std::string> profiles;
+        double hot_percent = 1.0;
+        int level = 0;
+    };
+
+    struct instantiation {
+        std::uint64_t site{};
+        std::uint64_t calls{};
+        int level{};
+        std::size_t size{};
+        // Construction site with the most calls, quoted in the generated header.
+        std::string where;
+        std::uint64_t where_calls{};
+    };
+
+    constexpr const char* level_names[] = {"Low", "Medium", "High"};
+
+    int usage() {
+        std::fprintf(
+            stderr, "usage: obfuscxx_levels <output.h> <profile>... [--hot <percent>] [--level low|medium|high]\n"
+        );
+        return 1;
+    }
+
+    int parse_level(const std::string& value) {
+        for (int i{}; i < 3; ++i) {
+            std::string lower = level_names[i];
+            lower[0] = static_cast<char>(lower[0] - 'A' + 'a');
+            if (value == level_names[i] || value == lower) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Lines are "<site> <calls> <level> <size> <line> <file>"; the file name runs to the end of the line.
+    bool read_profile(const std::string& path, std::map<std::uint64_t, instantiation>& sites) {
+        std::ifstream in(path);
+        if (!in) {
+            return false;
+        }
+        for (std::string line; std::getline(in, line);) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string site;
+            std::uint64_t calls{};
+            std::string level;
+            std::size_t size{};
+            std::uint32_t source_line{};
+            if (!(fields >> site >> calls >> level >> size >> source_line)) {
+                continue;
+            }
+            std::string file;
+            std::getline(fields >> std::ws, file);
+
+            instantiation& entry = sites[std::stoull(site, nullptr, 16)];
+            entry.site = std::stoull(site, nullptr, 16);
+            entry.calls += calls;
+            entry.level = std::max(parse_level(level), 0);
+            entry.size = size;
+            if (calls >= entry.where_calls) {
+                entry.where = file + ":" + std::to_string(source_line);
+                entry.where_calls = calls;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        return usage();
+    }
+
+    options opts;
+    opts.output = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--hot" || arg == "--level") {
+            if (i + 1 >= argc) {
+                return usage();
+            }
+            std::string const value = argv[++i];
+            if (arg == "--hot") {
+                opts.hot_percent = std::stod(value);
+            } else if ((opts.level = parse_level(value)) < 0) {
+                return usage();
+            }
+        } else {
+            opts.profiles.push_back(arg);
+        }
+    }
+    if (opts.profiles.empty()) {
+        return usage();
+    }
+
+    std::map<std::uint64_t, instantiation> sites;
+    for (const std::string& profile : opts.profiles) {
+        if (!read_profile(profile, sites)) {
+            std::fprintf(stderr, "obfuscxx_levels: cannot open %s\n", profile.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<instantiation> ranked;
+    for (const auto& [site, entry] : sites) {
+        ranked.push_back(entry);
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const instantiation& a, const instantiation& b) {
+        return a.calls != b.calls ? a.calls > b.calls : a.site < b.site;
+    });
+    auto const hot = static_cast<std::size_t>(std::ceil(static_cast<double>(ranked.size()) * opts.hot_percent / 100.0));
+
+    std::FILE* out = std::fopen(opts.output.c_str(), "wb");
+    if (out == nullptr) {
+        std::fprintf(stderr, "obfuscxx_levels: cannot write %s\n", opts.output.c_str());
+        return 1;
+    }
+
+    std::fprintf(out, "// Generated by obfuscxx_levels. Do not edit.\n");
+    std::fprintf(
+        out,
+        "// %zu of %zu profiled instantiations are in the hottest %g%%.\n\n",
+        std::min(hot, ranked.size()),
+        ranked.size(),
+        opts.hot_percent
+    );
+    for (std::size_t i{}; i < hot && i < ranked.size(); ++i) {
+        const instantiation& entry = ranked[i];
+        if (entry.calls == 0 || entry.level <= opts.level) {
+            continue;
+        }
+        std::fprintf(
+            out,
+            "// %llu calls, %s[%zu] at %s\nOBFUSCXX_LEVEL_OVERRIDE(0x%016llxULL, %s)\n",
+            static_cast<unsigned long long>(entry.calls),
+            level_names[entry.level],
+            entry.size,
+            entry.where.c_str(),
+            static_cast<unsigned long long>(entry.site),
+            level_names[opts.level]
+        );
+    }
+
+    return std::fclose(out) == 0 ? 0 : 1;
+}